@@ -0,0 +1,85 @@
+#ifndef PHYSICS2D_BENCHMARK_H
+#define PHYSICS2D_BENCHMARK_H
+#include <string>
+
+#include "scenes/bridge.h"
+#include "scenes/continuous.h"
+#include "scenes/domino.h"
+#include "scenes/mixed.h"
+#include "scenes/projectile.h"
+#include "scenes/pyramid.h"
+#include "scenes/stacking.h"
+#include "scenes/wreckingball.h"
+#include "scenes/xpbd.h"
+
+namespace Physics2D
+{
+	struct BenchmarkSettings
+	{
+		int steps = 1000;
+		int warmup = 60;
+		int frequency = 60;
+		int velocityIteration = 6;
+		int positionIteration = 4;
+		bool sleep = false;
+		bool parallel = false;
+		//0 means one thread per hardware thread
+		int threads = 0;
+		bool wide = false;
+		//send every pair through gjk and epa instead of the analytic contact paths
+		bool gjk = false;
+		//find gjk and epa support points through the shape type switch instead of per pair kernels
+		bool switchSupport = false;
+		//generate contacts for every broadphase pair instead of rejecting separated pairs with the batched gjk first
+		bool noRejection = false;
+		//sweep the broadphase boxes by velocity and give pairs about to touch speculative contacts
+		bool speculative = false;
+		//sub-steps of the soft step, 0 keeps the velocity and position iterations
+		int subSteps = 0;
+		//sub-steps of the xpbd solver, 0 keeps the impulse solver
+		int xpbdSubSteps = 0;
+	};
+
+	struct BenchmarkResult
+	{
+		std::string scene;
+		size_t bodyCount = 0;
+		size_t jointCount = 0;
+		int steps = 0;
+		//wall time per step, in milliseconds
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double total = 0.0;
+		//mean distance a dynamic body moved over the measured steps. Bodies of a settled stack stay where
+		//they are, so it measures how well the solver holds them
+		double drift = 0.0;
+		//per-phase mean over the measured steps
+		StepProfile profile;
+	};
+
+	class Benchmark
+	{
+	public:
+		using SceneFactory = std::function<Scene*(const SceneSettings&)>;
+
+		Benchmark();
+		Container::Vector<std::string> sceneNames() const;
+		std::optional<BenchmarkResult> run(const std::string& name, const BenchmarkSettings& settings) const;
+
+		static void printTable(const Container::Vector<BenchmarkResult>& results);
+		static void printCSV(const Container::Vector<BenchmarkResult>& results);
+		static void printProfile(const Container::Vector<BenchmarkResult>& results);
+
+		//compare the analytic contact paths against gjk and epa over random poses of every shape pair,
+		//false if an analytic result does not separate the shapes
+		static bool checkContacts(int samples);
+		//time the polygon support searches of the narrowphase over 4 to 64 vertices, queries searches each
+		static void benchmarkSupport(int queries);
+
+	private:
+		Container::Vector<std::pair<std::string, SceneFactory>> m_sceneList;
+	};
+}
+#endif
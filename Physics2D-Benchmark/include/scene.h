@@ -0,0 +1,48 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENE_H
+#define PHYSICS2D_BENCHMARK_SCENE_H
+#include "physics2d.h"
+
+namespace Physics2D
+{
+	struct SceneSettings
+	{
+		PhysicsWorld* world = nullptr;
+		ContactMaintainer* maintainer = nullptr;
+		Tree* tree = nullptr;
+		UniformGrid* grid = nullptr;
+		PhysicsSystem* system = nullptr;
+	};
+
+	//headless counterpart of the testbed Frame, only the physics callbacks are kept
+	class Scene
+	{
+	public:
+		Scene(const SceneSettings& settings) : m_settings(settings)
+		{
+		}
+
+		virtual ~Scene()
+		{
+		}
+
+		virtual void onLoad()
+		{
+		}
+
+		virtual void onUnLoad()
+		{
+		}
+
+		virtual void onPreStep(real)
+		{
+		}
+
+		virtual void onPostStep(real)
+		{
+		}
+
+	protected:
+		SceneSettings m_settings;
+	};
+}
+#endif
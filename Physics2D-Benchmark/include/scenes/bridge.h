@@ -0,0 +1,24 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_BRIDGE_H
+#define PHYSICS2D_BENCHMARK_SCENES_BRIDGE_H
+#include "scene.h"
+#include "worlds/bridge.h"
+
+namespace Physics2D
+{
+	class BridgeScene : public Scene
+	{
+	public:
+		BridgeScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			world.create(m_settings.world, m_settings.tree);
+		}
+
+	private:
+		BridgeWorld world;
+	};
+}
+#endif
@@ -0,0 +1,101 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_CONTINUOUS_H
+#define PHYSICS2D_BENCHMARK_SCENES_CONTINUOUS_H
+#include "scene.h"
+
+namespace Physics2D
+{
+	//the testbed scene with a pyramid next to the column, so that bullets share the step with a busy world.
+	//a new pair of bullets is fired every second
+	class ContinuousScene : public Scene
+	{
+	public:
+		ContinuousScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			block.set(1000.0f, 60.0f);
+			rect.set(1.0f, 1.0f);
+			circle.setRadius(0.5f);
+			stick.set(2.0f, 0.5f);
+			wall.set(60.0, 1000.0f);
+
+			Body* ground = m_settings.world->createBody();
+			ground->setShape(&block);
+			ground->position().set({0, -30});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(0.9f);
+			m_settings.tree->insert(ground);
+
+			for (real j = 0; j < 20.0f; j += 1.0f)
+			{
+				Body* body = m_settings.world->createBody();
+				body->position().set({-2.0f, j * 1.05f + 0.55f});
+				body->setShape(&rect);
+				body->rotation() = 0.0f;
+				body->setMass(1.0f);
+				body->setType(Body::BodyType::Dynamic);
+				body->setFriction(0.5f);
+				body->setRestitution(0.0f);
+				m_settings.tree->insert(body);
+			}
+
+			const int rows = 20;
+			for (int j = 0; j < rows; ++j)
+			{
+				for (int i = 0; i < rows - j; ++i)
+				{
+					Body* body = m_settings.world->createBody();
+					body->position().set({20.0f + static_cast<real>(i) * 1.1f + static_cast<real>(j) * 0.55f,
+					                      static_cast<real>(j) * 1.05f + 0.55f});
+					body->setShape(&rect);
+					body->setMass(1.0f);
+					body->setType(Body::BodyType::Dynamic);
+					body->setFriction(0.5f);
+					m_settings.tree->insert(body);
+				}
+			}
+
+			Body* wallBody = m_settings.world->createBody();
+			wallBody->setShape(&wall);
+			wallBody->position().set(180.0f, 0.0f);
+			wallBody->setMass(Constant::Max);
+			wallBody->setFriction(0.9f);
+			wallBody->setType(Body::BodyType::Static);
+			m_settings.tree->insert(wallBody);
+		}
+
+		void onPreStep(real) override
+		{
+			//a spinning circle into the column and a spinning stick into the pyramid
+			if (m_fired++ % 60 != 0)
+				return;
+			fire(&circle, {-100.0f, 8.5f}, {1500.0f, 0.0f}, -500.0f);
+			fire(&stick, {-60.0f, 4.0f}, {1200.0f, 0.0f}, 50.0f);
+		}
+
+	private:
+		void fire(Shape* shape, const Vector2& position, const Vector2& velocity, real angularVelocity)
+		{
+			Body* bullet = m_settings.world->createBody();
+			bullet->setShape(shape);
+			bullet->position() = position;
+			bullet->setType(Body::BodyType::Bullet);
+			bullet->setMass(10.0f);
+			bullet->velocity() = velocity;
+			bullet->angularVelocity() = angularVelocity;
+			bullet->setFriction(0.9f);
+			m_settings.tree->insert(bullet);
+		}
+
+		int m_fired = 0;
+		Rectangle block;
+		Rectangle rect;
+		Rectangle stick;
+		Rectangle wall;
+		Circle circle;
+	};
+}
+#endif
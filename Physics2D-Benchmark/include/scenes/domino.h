@@ -0,0 +1,24 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_DOMINO_H
+#define PHYSICS2D_BENCHMARK_SCENES_DOMINO_H
+#include "scene.h"
+#include "worlds/domino.h"
+
+namespace Physics2D
+{
+	class DominoScene : public Scene
+	{
+	public:
+		DominoScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			world.create(m_settings.world, m_settings.tree);
+		}
+
+	private:
+		DominoWorld world;
+	};
+}
+#endif
@@ -0,0 +1,89 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_MIXED_H
+#define PHYSICS2D_BENCHMARK_SCENES_MIXED_H
+#include <random>
+#include "scene.h"
+
+namespace Physics2D
+{
+	//every shape type dropped into a box, seeded so each run sees the same pile
+	class MixedScene : public Scene
+	{
+	public:
+		MixedScene(const SceneSettings& settings, int count = 600) : Scene(settings), m_count(count)
+		{
+		}
+
+		void onLoad() override
+		{
+			rectangle.set(0.8f, 0.8f);
+			circle.setRadius(0.4f);
+			capsule.set(1.2f, 0.5f);
+			triangle.append({{-1.0f, 1.0f}, {0.0f, -2.0f}, {1.0f, -1.0f}});
+			polygon.append({
+				{0.0f, 4.0f}, {-3.0f, 3.0f}, {-4.0f, 0.0f}, {-3.0f, -3.0f}, {0, -4.0f},
+				{3.0f, -3.0f}, {4.0f, 0.0f}, {3.0f, 3.0f}
+			});
+			triangle.scale(0.4f);
+			polygon.scale(0.12f);
+			floor.set({-20.0f, 0.0f}, {20.0f, 0.0f});
+			wall.set(1.0f, 60.0f);
+
+			Body* ground = m_settings.world->createBody();
+			ground->setShape(&floor);
+			ground->position().set({0.0f, 0.0f});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(0.4f);
+			m_settings.tree->insert(ground);
+
+			for (real x : {-20.5f, 20.5f})
+			{
+				Body* side = m_settings.world->createBody();
+				side->setShape(&wall);
+				side->position().set({x, 30.0f});
+				side->setMass(Constant::Max);
+				side->setType(Body::BodyType::Static);
+				side->setFriction(0.4f);
+				m_settings.tree->insert(side);
+			}
+
+			Shape* shapeArray[5];
+			shapeArray[0] = &rectangle;
+			shapeArray[1] = &circle;
+			shapeArray[2] = &triangle;
+			shapeArray[3] = &polygon;
+			shapeArray[4] = &capsule;
+
+			std::mt19937 gen(20240101);
+			std::uniform_real_distribution<real> angle(-Constant::Pi, Constant::Pi);
+			std::uniform_real_distribution<real> jitter(-0.1f, 0.1f);
+
+			const int columns = 30;
+			for (int i = 0; i < m_count; ++i)
+			{
+				const real x = -18.0f + static_cast<real>(i % columns) * 1.25f + jitter(gen);
+				const real y = 2.0f + static_cast<real>(i / columns) * 1.3f;
+				Body* body = m_settings.world->createBody();
+				body->position().set({x, y});
+				body->setShape(shapeArray[i % 5]);
+				body->rotation() = angle(gen);
+				body->setMass(1.0f);
+				body->setType(Body::BodyType::Dynamic);
+				body->setFriction(0.4f);
+				body->setRestitution(0.0f);
+				m_settings.tree->insert(body);
+			}
+		}
+
+	private:
+		int m_count;
+		Rectangle rectangle;
+		Rectangle wall;
+		Circle circle;
+		Capsule capsule;
+		Polygon triangle;
+		Polygon polygon;
+		Edge floor;
+	};
+}
+#endif
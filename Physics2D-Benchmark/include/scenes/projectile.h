@@ -0,0 +1,85 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_PROJECTILE_H
+#define PHYSICS2D_BENCHMARK_SCENES_PROJECTILE_H
+#include "scene.h"
+
+namespace Physics2D
+{
+	//fast dynamic bodies that are not bullets, fired at thin plates. Every step they move several times the
+	//thickness of a plate, so they pass through unless speculative contacts are on
+	class ProjectileScene : public Scene
+	{
+	public:
+		ProjectileScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			block.set(1000.0f, 60.0f);
+			plate.set(0.2f, 20.0f);
+			rect.set(1.0f, 1.0f);
+			circle.setRadius(0.5f);
+
+			Body* ground = m_settings.world->createBody();
+			ground->setShape(&block);
+			ground->position().set({0, -30});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(0.9f);
+			m_settings.tree->insert(ground);
+
+			//a plate on either side of the launch point, and a tilted one above it
+			for (const real x : {-60.0f, 60.0f})
+			{
+				Body* body = m_settings.world->createBody();
+				body->setShape(&plate);
+				body->position().set({x, 10.0f});
+				body->setMass(Constant::Max);
+				body->setType(Body::BodyType::Static);
+				body->setFriction(0.5f);
+				m_settings.tree->insert(body);
+			}
+			Body* roof = m_settings.world->createBody();
+			roof->setShape(&plate);
+			roof->position().set({0.0f, 60.0f});
+			roof->rotation() = Constant::HalfPi * 0.8f;
+			roof->setMass(Constant::Max);
+			roof->setType(Body::BodyType::Static);
+			roof->setFriction(0.5f);
+			m_settings.tree->insert(roof);
+		}
+
+		void onPreStep(real) override
+		{
+			//300 m/s covers 5 units in a step at 60 hz
+			if (m_fired++ % 10 != 0)
+				return;
+			const real spread = static_cast<real>(m_fired % 7) - 3.0f;
+			fire(&rect, {2.0f, 10.0f + spread}, {300.0f, 10.0f * spread}, 5.0f);
+			fire(&circle, {-2.0f, 10.0f - spread}, {-300.0f, 10.0f * spread}, 0.0f);
+			fire(&rect, {spread, 20.0f}, {10.0f * spread, 300.0f}, -3.0f);
+		}
+
+	private:
+		void fire(Shape* shape, const Vector2& position, const Vector2& velocity, real angularVelocity)
+		{
+			Body* body = m_settings.world->createBody();
+			body->setShape(shape);
+			body->position() = position;
+			body->setType(Body::BodyType::Dynamic);
+			body->setMass(1.0f);
+			body->velocity() = velocity;
+			body->angularVelocity() = angularVelocity;
+			body->setFriction(0.5f);
+			body->setRestitution(0.0f);
+			m_settings.tree->insert(body);
+		}
+
+		int m_fired = 0;
+		Rectangle block;
+		Rectangle plate;
+		Rectangle rect;
+		Circle circle;
+	};
+}
+#endif
@@ -0,0 +1,54 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_PYRAMID_H
+#define PHYSICS2D_BENCHMARK_SCENES_PYRAMID_H
+#include "scene.h"
+
+namespace Physics2D
+{
+	//large version of stacking, rows * (rows + 1) / 2 boxes
+	class PyramidScene : public Scene
+	{
+	public:
+		PyramidScene(const SceneSettings& settings, int rows = 60) : Scene(settings), m_rows(rows)
+		{
+		}
+
+		void onLoad() override
+		{
+			edge.set({-200, 0}, {200, 0});
+			rectangle.set(1.0f, 1.0f);
+
+			Body* ground = m_settings.world->createBody();
+			ground->setShape(&edge);
+			ground->position().set({0.0, 0.0});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(1.0f);
+			m_settings.tree->insert(ground);
+
+			const real max = static_cast<real>(m_rows);
+			real offset = -max * 0.5f * 1.05f;
+			for (real j = 0; j < max; j += 1.0f)
+			{
+				for (real i = 0.0; i < max - j; i += 1.0f)
+				{
+					Body* body = m_settings.world->createBody();
+					body->position().set({i * 1.05f + offset, j * 1.05f + 0.6f});
+					body->setShape(&rectangle);
+					body->rotation() = 0;
+					body->setMass(1.0f);
+					body->setType(Body::BodyType::Dynamic);
+					body->setFriction(1.0f);
+					body->setRestitution(0.0f);
+					m_settings.tree->insert(body);
+				}
+				offset += 0.525f;
+			}
+		}
+
+	private:
+		int m_rows;
+		Rectangle rectangle;
+		Edge edge;
+	};
+}
+#endif
@@ -0,0 +1,24 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_STACKING_H
+#define PHYSICS2D_BENCHMARK_SCENES_STACKING_H
+#include "scene.h"
+#include "worlds/stacking.h"
+
+namespace Physics2D
+{
+	class StackingScene : public Scene
+	{
+	public:
+		StackingScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			world.create(m_settings.world, m_settings.tree);
+		}
+
+	private:
+		StackingWorld world;
+	};
+}
+#endif
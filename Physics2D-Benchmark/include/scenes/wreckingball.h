@@ -0,0 +1,24 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_WRECKINGBALL_H
+#define PHYSICS2D_BENCHMARK_SCENES_WRECKINGBALL_H
+#include "scene.h"
+#include "worlds/wreckingball.h"
+
+namespace Physics2D
+{
+	class WreckingBallScene : public Scene
+	{
+	public:
+		WreckingBallScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			world.create(m_settings.world, m_settings.tree);
+		}
+
+	private:
+		WreckingBallWorld world;
+	};
+}
+#endif
@@ -0,0 +1,25 @@
+#ifndef PHYSICS2D_BENCHMARK_SCENES_XPBD_H
+#define PHYSICS2D_BENCHMARK_SCENES_XPBD_H
+#include "scene.h"
+#include "worlds/xpbd.h"
+
+namespace Physics2D
+{
+	//run it with and without --xpbd to compare the solver backends on the same world
+	class XPBDScene : public Scene
+	{
+	public:
+		XPBDScene(const SceneSettings& settings) : Scene(settings)
+		{
+		}
+
+		void onLoad() override
+		{
+			world.create(m_settings.world, m_settings.tree);
+		}
+
+	private:
+		XPBDWorld world;
+	};
+}
+#endif
@@ -0,0 +1,175 @@
+#include "benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	void printUsage(const char* program, const Physics2D::Benchmark& benchmark)
+	{
+		std::printf("usage: %s [scene ...] [options]\n\n", program);
+		std::printf("options:\n");
+		std::printf("  --steps N        measured steps per scene (default 1000)\n");
+		std::printf("  --warmup N       unmeasured steps before measuring (default 60)\n");
+		std::printf("  --hz N           step frequency, dt = 1 / N (default 60)\n");
+		std::printf("  --velocity N     velocity iterations (default 6)\n");
+		std::printf("  --position N     position iterations (default 4)\n");
+		std::printf("  --sleep          enable body sleeping\n");
+		std::printf("  --parallel       solve islands on worker threads\n");
+		std::printf("  --threads N      worker pool size including the main thread (default: hardware threads)\n");
+		std::printf("  --wide           solve contacts of large islands four at a time with SIMD\n");
+		std::printf("  --gjk            use gjk and epa for every pair instead of the analytic contact paths\n");
+		std::printf("  --switch-support find gjk and epa support points through the shape type switch\n");
+		std::printf("  --no-reject      skip the batched gjk that rejects separated pairs before contact generation\n");
+		std::printf("  --speculative    sweep broadphase boxes by velocity and make speculative contacts for pairs about to touch\n");
+		std::printf("  --soft-step N    take N soft sub-steps per step instead of the velocity and position iterations\n");
+		std::printf("  --xpbd N         solve contacts and joints with the xpbd solver in N sub-steps per step\n");
+		std::printf("  --check-contacts N\n");
+		std::printf("                   compare the analytic contact paths with gjk and epa over N random poses\n");
+		std::printf("                   of every shape pair and exit, fails if an analytic result is invalid\n");
+		std::printf("  --support N      time the polygon support searches over N directions for 4 to 64 vertices\n");
+		std::printf("                   and exit\n");
+		std::printf("  --csv            print results as csv\n");
+		std::printf("  --profile        also print the mean time of every step phase\n");
+		std::printf("  --list           list scenes and exit\n\n");
+		std::printf("scenes:");
+		for (const auto& name : benchmark.sceneNames())
+			std::printf(" %s", name.c_str());
+		std::printf("\nwith no scene given, every scene is run.\n");
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Physics2D::Benchmark benchmark;
+	Physics2D::BenchmarkSettings settings;
+	Physics2D::Container::Vector<std::string> scenes;
+	bool csv = false;
+	bool profile = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* arg = argv[i];
+		auto intValue = [&](int& target)
+		{
+			if (i + 1 >= argc)
+			{
+				std::fprintf(stderr, "missing value for %s\n", arg);
+				std::exit(EXIT_FAILURE);
+			}
+			target = std::atoi(argv[++i]);
+		};
+
+		if (std::strcmp(arg, "--steps") == 0)
+			intValue(settings.steps);
+		else if (std::strcmp(arg, "--warmup") == 0)
+			intValue(settings.warmup);
+		else if (std::strcmp(arg, "--hz") == 0)
+			intValue(settings.frequency);
+		else if (std::strcmp(arg, "--velocity") == 0)
+			intValue(settings.velocityIteration);
+		else if (std::strcmp(arg, "--position") == 0)
+			intValue(settings.positionIteration);
+		else if (std::strcmp(arg, "--sleep") == 0)
+			settings.sleep = true;
+		else if (std::strcmp(arg, "--parallel") == 0)
+			settings.parallel = true;
+		else if (std::strcmp(arg, "--threads") == 0)
+			intValue(settings.threads);
+		else if (std::strcmp(arg, "--wide") == 0)
+			settings.wide = true;
+		else if (std::strcmp(arg, "--gjk") == 0)
+			settings.gjk = true;
+		else if (std::strcmp(arg, "--switch-support") == 0)
+			settings.switchSupport = true;
+		else if (std::strcmp(arg, "--no-reject") == 0)
+			settings.noRejection = true;
+		else if (std::strcmp(arg, "--speculative") == 0)
+			settings.speculative = true;
+		else if (std::strcmp(arg, "--soft-step") == 0)
+			intValue(settings.subSteps);
+		else if (std::strcmp(arg, "--xpbd") == 0)
+			intValue(settings.xpbdSubSteps);
+		else if (std::strcmp(arg, "--check-contacts") == 0)
+		{
+			int samples = 0;
+			intValue(samples);
+			if (samples <= 0)
+			{
+				std::fprintf(stderr, "--check-contacts needs a positive sample count\n");
+				return EXIT_FAILURE;
+			}
+			return Physics2D::Benchmark::checkContacts(samples) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (std::strcmp(arg, "--support") == 0)
+		{
+			int queries = 0;
+			intValue(queries);
+			if (queries <= 0)
+			{
+				std::fprintf(stderr, "--support needs a positive query count\n");
+				return EXIT_FAILURE;
+			}
+			Physics2D::Benchmark::benchmarkSupport(queries);
+			return EXIT_SUCCESS;
+		}
+		else if (std::strcmp(arg, "--csv") == 0)
+			csv = true;
+		else if (std::strcmp(arg, "--profile") == 0)
+			profile = true;
+		else if (std::strcmp(arg, "--list") == 0)
+		{
+			for (const auto& name : benchmark.sceneNames())
+				std::printf("%s\n", name.c_str());
+			return EXIT_SUCCESS;
+		}
+		else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+		{
+			printUsage(argv[0], benchmark);
+			return EXIT_SUCCESS;
+		}
+		else if (arg[0] == '-')
+		{
+			std::fprintf(stderr, "unknown option %s\n", arg);
+			printUsage(argv[0], benchmark);
+			return EXIT_FAILURE;
+		}
+		else if (std::strcmp(arg, "all") != 0)
+			scenes.emplace_back(arg);
+	}
+
+	if (settings.steps <= 0 || settings.warmup < 0 || settings.frequency <= 0 ||
+		settings.velocityIteration <= 0 || settings.positionIteration <= 0 || settings.threads < 0 || settings.subSteps < 0 ||
+		settings.xpbdSubSteps < 0)
+	{
+		std::fprintf(stderr, "steps, hz and iterations must be positive, warmup, threads and sub-steps must not be negative\n");
+		return EXIT_FAILURE;
+	}
+
+	const auto names = benchmark.sceneNames();
+	if (scenes.empty())
+		scenes = names;
+
+	for (const auto& name : scenes)
+	{
+		if (std::find(names.begin(), names.end(), name) == names.end())
+		{
+			std::fprintf(stderr, "unknown scene %s\n", name.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	Physics2D::Container::Vector<Physics2D::BenchmarkResult> results;
+	for (const auto& name : scenes)
+		results.emplace_back(benchmark.run(name, settings).value());
+
+	if (csv)
+		Physics2D::Benchmark::printCSV(results);
+	else
+		Physics2D::Benchmark::printTable(results);
+
+	if (profile && !csv)
+		Physics2D::Benchmark::printProfile(results);
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,462 @@
+#include "benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace Physics2D
+{
+	namespace
+	{
+		constexpr real ContactTolerance = 0.002f;
+
+		//pushing A out along the normal by the penetration must separate the pair, stopping short of it must not
+		bool separates(const Collision& collision, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB)
+		{
+			ShapePrimitive moved = shapeA;
+			moved.transform.position = shapeA.transform.position + collision.normal * (collision.penetration + ContactTolerance);
+			if (Detector::collide(moved, shapeB))
+				return false;
+			moved.transform.position = shapeA.transform.position + collision.normal * (collision.penetration - ContactTolerance);
+			return Detector::collide(moved, shapeB);
+		}
+
+		//every contact is pointA on A and pointB on B, apart along the normal by no more than the penetration
+		bool validContacts(const Collision& collision)
+		{
+			for (uint32_t i = 0; i < collision.contactList.count; i += 2)
+			{
+				const Vector2 offset = collision.contactList.points[i + 1] - collision.contactList.points[i];
+				const real depth = offset.dot(collision.normal);
+				if (depth < -ContactTolerance || depth > collision.penetration + ContactTolerance ||
+					Math::abs(offset.cross(collision.normal)) > ContactTolerance)
+					return false;
+			}
+			return true;
+		}
+	}
+
+	Benchmark::Benchmark()
+	{
+		m_sceneList = {
+			{
+				"bridge", [](const SceneSettings& settings)
+				{
+					return new BridgeScene(settings);
+				}
+			},
+			{
+				"continuous", [](const SceneSettings& settings)
+				{
+					return new ContinuousScene(settings);
+				}
+			},
+			{
+				"domino", [](const SceneSettings& settings)
+				{
+					return new DominoScene(settings);
+				}
+			},
+			{
+				"mixed", [](const SceneSettings& settings)
+				{
+					return new MixedScene(settings);
+				}
+			},
+			{
+				"projectile", [](const SceneSettings& settings)
+				{
+					return new ProjectileScene(settings);
+				}
+			},
+			{
+				"pyramid", [](const SceneSettings& settings)
+				{
+					return new PyramidScene(settings);
+				}
+			},
+			{
+				"stacking", [](const SceneSettings& settings)
+				{
+					return new StackingScene(settings);
+				}
+			},
+			{
+				"wreckingball", [](const SceneSettings& settings)
+				{
+					return new WreckingBallScene(settings);
+				}
+			},
+			{
+				"xpbd", [](const SceneSettings& settings)
+				{
+					return new XPBDScene(settings);
+				}
+			}
+		};
+	}
+
+	Container::Vector<std::string> Benchmark::sceneNames() const
+	{
+		Container::Vector<std::string> names;
+		names.reserve(m_sceneList.size());
+		for (const auto& elem : m_sceneList)
+			names.emplace_back(elem.first);
+		return names;
+	}
+
+	std::optional<BenchmarkResult> Benchmark::run(const std::string& name, const BenchmarkSettings& settings) const
+	{
+		auto iter = std::find_if(m_sceneList.begin(), m_sceneList.end(),
+		                         [&name](const auto& elem) { return elem.first == name; });
+		if (iter == m_sceneList.end())
+			return std::nullopt;
+
+		//fresh system for every run so that no state leaks from one scene into the next
+		auto system = std::make_unique<PhysicsSystem>();
+		system->world().setEnableGravity(true);
+		system->world().setGravity({0.0f, -10.0f});
+		system->world().setLinearVelocityDamping(0.0f);
+		system->world().setAirFrictionCoefficient(0.0f);
+		system->world().setAngularVelocityDamping(0.0f);
+		system->world().setEnableDamping(true);
+		system->world().enableSleep() = settings.sleep;
+		system->positionIteration() = settings.positionIteration;
+		system->velocityIteration() = settings.velocityIteration;
+		system->parallelSolve() = settings.parallel;
+		system->threadPool().setThreadCount(static_cast<size_t>(settings.threads));
+		system->maintainer().m_wideVelocitySolver = settings.wide;
+		system->analyticContacts() = !settings.gjk;
+		system->typedKernels() = !settings.switchSupport;
+		system->batchedRejection() = !settings.noRejection;
+		system->speculativeContacts() = settings.speculative;
+		system->softStep() = settings.subSteps > 0;
+		if (settings.subSteps > 0)
+			system->subStepCount() = settings.subSteps;
+		system->xpbd() = settings.xpbdSubSteps > 0;
+		if (settings.xpbdSubSteps > 0)
+			system->xpbdSolver().m_subStepCount = settings.xpbdSubSteps;
+
+		SceneSettings sceneSettings;
+		sceneSettings.world = &system->world();
+		sceneSettings.maintainer = &system->maintainer();
+		sceneSettings.tree = &system->tree();
+		sceneSettings.grid = &system->grid();
+		sceneSettings.system = system.get();
+
+		std::unique_ptr<Scene> scene(iter->second(sceneSettings));
+		scene->onLoad();
+
+		const real dt = 1.0f / static_cast<real>(settings.frequency);
+		auto step = [&]
+		{
+			scene->onPreStep(dt);
+			system->step(dt);
+			scene->onPostStep(dt);
+		};
+
+		for (int i = 0; i < settings.warmup; ++i)
+			step();
+
+		BenchmarkResult result;
+		StepProfile& profile = result.profile;
+
+		Container::Vector<std::pair<Body*, Vector2>> start;
+		for (const auto& body : system->world().bodyList())
+			if (body->type() == Body::BodyType::Dynamic)
+				start.emplace_back(body.get(), body->position());
+
+		Container::Vector<double> samples;
+		samples.reserve(settings.steps);
+		for (int i = 0; i < settings.steps; ++i)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			step();
+			const auto end = std::chrono::steady_clock::now();
+			samples.emplace_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+			const StepProfile& last = system->profile();
+			profile.integrateVelocity += last.integrateVelocity;
+			profile.broadphase += last.broadphase;
+			profile.narrowphase += last.narrowphase;
+			profile.buildIslands += last.buildIslands;
+			profile.prepareVelocity += last.prepareVelocity;
+			profile.solveVelocity += last.solveVelocity;
+			profile.integratePosition += last.integratePosition;
+			profile.solvePosition += last.solvePosition;
+			profile.updateTree += last.updateTree;
+			profile.ccd += last.ccd;
+			profile.total += last.total;
+			profile.pairCount += last.pairCount;
+			profile.collidingCount += last.collidingCount;
+			profile.contactPointCount += last.contactPointCount;
+			profile.ccdSolveCount += last.ccdSolveCount;
+			profile.toiQueryCount += last.toiQueryCount;
+			profile.islandCount += last.islandCount;
+			profile.awakeIslandCount += last.awakeIslandCount;
+			profile.colorCount += last.colorCount;
+			profile.gjkCount += last.gjkCount;
+			profile.gjkIterationCount += last.gjkIterationCount;
+			profile.reusedCount += last.reusedCount;
+			profile.rejectedCount += last.rejectedCount;
+			profile.speculativeCount += last.speculativeCount;
+		}
+
+		result.scene = name;
+		result.bodyCount = system->world().bodyList().size();
+		result.jointCount = system->world().jointList().size();
+		result.steps = settings.steps;
+		for (const auto& [body, position] : start)
+			result.drift += (body->position() - position).length();
+		if (!start.empty())
+			result.drift /= static_cast<double>(start.size());
+
+		if (!samples.empty())
+		{
+			for (const double& sample : samples)
+				result.total += sample;
+			result.mean = result.total / static_cast<double>(samples.size());
+
+			std::sort(samples.begin(), samples.end());
+			//nearest-rank percentile
+			auto percentile = [&samples](double p)
+			{
+				size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(samples.size())));
+				rank = std::clamp<size_t>(rank, 1, samples.size());
+				return samples[rank - 1];
+			};
+			result.p50 = percentile(0.50);
+			result.p99 = percentile(0.99);
+			result.max = samples.back();
+
+			const double count = static_cast<double>(samples.size());
+			profile.integrateVelocity /= count;
+			profile.broadphase /= count;
+			profile.narrowphase /= count;
+			profile.buildIslands /= count;
+			profile.prepareVelocity /= count;
+			profile.solveVelocity /= count;
+			profile.integratePosition /= count;
+			profile.solvePosition /= count;
+			profile.updateTree /= count;
+			profile.ccd /= count;
+			profile.total /= count;
+			profile.pairCount /= samples.size();
+			profile.collidingCount /= samples.size();
+			profile.contactPointCount /= samples.size();
+			profile.ccdSolveCount /= samples.size();
+			profile.toiQueryCount /= samples.size();
+			profile.islandCount /= samples.size();
+			profile.awakeIslandCount /= samples.size();
+			profile.colorCount /= samples.size();
+			profile.gjkCount /= samples.size();
+			profile.gjkIterationCount /= samples.size();
+			profile.reusedCount /= samples.size();
+			profile.rejectedCount /= samples.size();
+			profile.speculativeCount /= samples.size();
+		}
+
+		scene->onUnLoad();
+		return result;
+	}
+
+	void Benchmark::printTable(const Container::Vector<BenchmarkResult>& results)
+	{
+		std::printf("%-14s %7s %7s %7s %10s %10s %10s %10s %11s %9s\n",
+		            "scene", "bodies", "joints", "steps", "mean(ms)", "p50(ms)", "p99(ms)", "max(ms)", "total(ms)", "drift");
+		for (const auto& result : results)
+			std::printf("%-14s %7zu %7zu %7d %10.4f %10.4f %10.4f %10.4f %11.2f %9.4f\n",
+			            result.scene.c_str(), result.bodyCount, result.jointCount, result.steps,
+			            result.mean, result.p50, result.p99, result.max, result.total, result.drift);
+	}
+
+	void Benchmark::printCSV(const Container::Vector<BenchmarkResult>& results)
+	{
+		std::printf("scene,bodies,joints,steps,mean_ms,p50_ms,p99_ms,max_ms,total_ms,drift\n");
+		for (const auto& result : results)
+			std::printf("%s,%zu,%zu,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f\n",
+			            result.scene.c_str(), result.bodyCount, result.jointCount, result.steps,
+			            result.mean, result.p50, result.p99, result.max, result.total, result.drift);
+	}
+
+	void Benchmark::printProfile(const Container::Vector<BenchmarkResult>& results)
+	{
+		std::printf("\nmean per step (ms)\n");
+		std::printf("%-14s %9s %9s %9s %9s %9s %9s %9s %9s %9s %9s %8s %8s %8s %8s %8s %8s %6s %6s %8s %8s %7s %7s %7s\n",
+		            "scene", "intVel", "broad", "narrow", "island", "prepare", "solveVel", "intPos", "solvePos", "tree",
+		            "ccd", "pairs", "collide", "spec", "reused", "rejected", "points", "ccdRe", "toiQ", "islands", "awake", "colors", "gjk",
+		            "gjkIter");
+		for (const auto& result : results)
+		{
+			const StepProfile& profile = result.profile;
+			//mean iterations of one gjk run
+			const double gjkIterations = profile.gjkCount == 0 ? 0.0 :
+				static_cast<double>(profile.gjkIterationCount) / static_cast<double>(profile.gjkCount);
+			std::printf("%-14s %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %9.4f %8zu %8zu %8zu %8zu %8zu %8zu %6zu %6zu %8zu %8zu %7zu %7zu %7.2f\n",
+			            result.scene.c_str(), profile.integrateVelocity, profile.broadphase, profile.narrowphase,
+			            profile.buildIslands, profile.prepareVelocity, profile.solveVelocity, profile.integratePosition,
+			            profile.solvePosition, profile.updateTree, profile.ccd, profile.pairCount,
+			            profile.collidingCount, profile.speculativeCount, profile.reusedCount, profile.rejectedCount, profile.contactPointCount,
+			            profile.ccdSolveCount, profile.toiQueryCount, profile.islandCount, profile.awakeIslandCount, profile.colorCount,
+			            profile.gjkCount, gjkIterations);
+		}
+	}
+
+	bool Benchmark::checkContacts(int samples)
+	{
+		Rectangle box(1.0f, 0.6f);
+		Polygon triangle;
+		triangle.append({{0.0f, 1.0f}, {-1.0f, -0.5f}, {1.0f, -0.5f}});
+		Polygon pentagon;
+		for (int i = 0; i < 5; ++i)
+		{
+			const real angle = static_cast<real>(i) * Constant::DoublePi / 5.0f;
+			pentagon.append(Vector2(std::cos(angle), std::sin(angle)) * 0.7f);
+		}
+		Capsule capsule(1.5f, 0.5f);
+		Capsule tallCapsule(0.4f, 1.4f);
+		Circle circle(0.5f);
+
+		const std::pair<const char*, Shape*> shapes[] = {
+			{"box", &box}, {"triangle", &triangle}, {"pentagon", &pentagon},
+			{"capsule", &capsule}, {"tallcapsule", &tallCapsule}, {"circle", &circle}
+		};
+
+		//fixed seed so that a failure can be reproduced
+		std::mt19937 engine(2024);
+		std::uniform_real_distribution<real> unit(0.0f, 1.0f);
+		bool passed = true;
+
+		std::printf("%-24s %9s %9s %9s %9s %9s %9s\n", "pair", "colliding", "agree", "invalid", "gjkInvalid", "rejected",
+		            "rejInvalid");
+		for (const auto& [nameA, shapeA] : shapes)
+		{
+			for (const auto& [nameB, shapeB] : shapes)
+			{
+				size_t colliding = 0;
+				size_t agree = 0;
+				size_t invalid = 0;
+				size_t gjkInvalid = 0;
+				size_t rejected = 0;
+				size_t rejectInvalid = 0;
+				GjkBatch batch;
+				for (int i = 0; i < samples; ++i)
+				{
+					ShapePrimitive primitiveA;
+					primitiveA.shape = shapeA;
+					primitiveA.transform.position.set(unit(engine) * 0.2f, unit(engine) * 0.2f);
+					primitiveA.transform.rotation = unit(engine) * Constant::DoublePi;
+					ShapePrimitive primitiveB;
+					primitiveB.shape = shapeB;
+					primitiveB.transform.position.set(unit(engine) * 2.0f - 1.0f, unit(engine) * 2.0f - 1.0f);
+					primitiveB.transform.rotation = unit(engine) * Constant::DoublePi;
+
+					const Collision fast = Detector::detect(primitiveA, primitiveB, nullptr, true);
+					const Collision reference = Detector::detect(primitiveA, primitiveB, nullptr, false);
+
+					//the batched gjk may only reject poses that neither path finds colliding
+					batch.clear();
+					bool separated = false;
+					if (batch.add(primitiveA, primitiveB))
+						Narrowphase::gjkSeparated(batch, &separated);
+					if (separated)
+					{
+						++rejected;
+						if (fast.isColliding || reference.isColliding)
+							++rejectInvalid;
+					}
+
+					//grazing poses may go either way
+					if ((!fast.isColliding && !reference.isColliding) ||
+						(fast.isColliding != reference.isColliding &&
+						 Math::max(fast.penetration, reference.penetration) < ContactTolerance))
+						continue;
+
+					++colliding;
+					if (fast.isColliding == reference.isColliding &&
+						fast.normal.dot(reference.normal) > 1.0f - ContactTolerance &&
+						Math::abs(fast.penetration - reference.penetration) < ContactTolerance)
+						++agree;
+					if (!fast.isColliding || !separates(fast, primitiveA, primitiveB) || !validContacts(fast))
+						++invalid;
+					if (!reference.isColliding || !separates(reference, primitiveA, primitiveB))
+						++gjkInvalid;
+				}
+				const std::string name = std::string(nameA) + "-" + nameB;
+				std::printf("%-24s %9zu %9zu %9zu %9zu %9zu %9zu\n", name.c_str(), colliding, agree, invalid, gjkInvalid,
+				            rejected, rejectInvalid);
+				passed = passed && invalid == 0 && rejectInvalid == 0;
+			}
+		}
+		return passed;
+	}
+
+	void Benchmark::benchmarkSupport(int queries)
+	{
+		//rotating directions are what gjk and epa ask for, random ones are the worst case for climbing
+		const double step = Constant::DoublePi * 0.01;
+		std::mt19937 engine(2024);
+		std::uniform_real_distribution<real> angle(0.0f, Constant::DoublePi);
+		Container::Vector<Vector2> rotating(queries);
+		Container::Vector<Vector2> random(queries);
+		for (int i = 0; i < queries; ++i)
+		{
+			rotating[i].set(static_cast<real>(std::cos(step * i)), static_cast<real>(std::sin(step * i)));
+			const real a = angle(engine);
+			random[i].set(std::cos(a), std::sin(a));
+		}
+
+		//printed at the end, so the searches are consumed
+		Index checksum = 0;
+		std::printf("%-9s %10s %10s %12s %12s\n", "vertices", "linear", "simd", "climbRotate", "climbRandom");
+		for (const int count : {4, 8, 16, 32, 64})
+		{
+			//append recenters the ring every time, so later vertices follow the shift of the first one
+			Polygon polygon;
+			const Vector2 first(1.0f, 0.0f);
+			for (int i = 0; i < count; ++i)
+			{
+				const real a = static_cast<real>(i) * Constant::DoublePi / static_cast<real>(count);
+				const Vector2 shift = polygon.vertices().empty() ? Vector2() : polygon.vertices()[0] - first;
+				polygon.append(Vector2(std::cos(a), std::sin(a)) + shift);
+			}
+
+			//nanoseconds per query, the index sum keeps the searches from being optimized away
+			Index sum = 0;
+			auto measure = [&](const auto& search)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				search();
+				const auto end = std::chrono::steady_clock::now();
+				return std::chrono::duration<double, std::nano>(end - start).count() / queries;
+			};
+			const double linear = measure([&]
+			{
+				for (const Vector2& direction : random)
+					sum += Narrowphase::findFurthestPoint(polygon.vertices(), direction).second;
+			});
+			const double simd = measure([&]
+			{
+				for (const Vector2& direction : random)
+					sum += Narrowphase::findFurthestPointByScan(polygon, direction).second;
+			});
+			auto climb = [&](const Container::Vector<Vector2>& directions)
+			{
+				return measure([&]
+				{
+					Index index = 0;
+					for (const Vector2& direction : directions)
+					{
+						index = Narrowphase::findFurthestPointByClimbing(polygon, direction, index).second;
+						sum += index;
+					}
+				});
+			};
+			const double climbRotate = climb(rotating);
+			const double climbRandom = climb(random);
+			checksum += sum;
+			std::printf("%-9d %10.2f %10.2f %12.2f %12.2f\n", count, linear, simd, climbRotate, climbRandom);
+		}
+		std::printf("checksum %u\n", checksum);
+	}
+}
@@ -16,15 +16,15 @@ namespace Physics2D
 		real width = 0;
 		real height = 0;
 		Vector2 position;
-		inline Vector2 topLeft()const;
-		inline Vector2 topRight()const;
-		inline Vector2 bottomLeft()const;
-		inline Vector2 bottomRight()const;
+		Vector2 topLeft()const;
+		Vector2 topRight()const;
+		Vector2 bottomLeft()const;
+		Vector2 bottomRight()const;
 
-		inline real minimumX()const;
-		inline real minimumY()const;
-		inline real maximumX()const;
-		inline real maximumY()const;
+		real minimumX()const;
+		real minimumY()const;
+		real maximumX()const;
+		real maximumY()const;
 
 		bool collide(const AABB& other) const;
 		void expand(const real& factor);
@@ -17,6 +17,8 @@
 
 namespace Physics2D
 {
+	struct BodyStore;
+
 	class PHYSICS2D_API Body
 	{
 	public:
@@ -47,12 +49,22 @@ namespace Physics2D
 			void step(const real& dt);
 		};
 
-		Body() = default;
+		//standalone body, owns a single-slot store
+		Body();
+		//body living in a world store
+		explicit Body(BodyStore* store);
+		~Body();
+		//the store keeps a pointer back to every body
+		Body(const Body&) = delete;
+		Body& operator=(const Body&) = delete;
+
 		Vector2& position();
 
 		Vector2& velocity();
 
 		real& rotation();
+		//matrix of the current rotation, rebuilt only when the rotation has changed since it was last built
+		const Matrix2x2& rotationMatrix() const;
 
 		real& angularVelocity();
 
@@ -66,6 +78,7 @@ namespace Physics2D
 		uint32_t& sleepCountdown();
 
 		Shape* shape() const;
+		//call again after editing the shape in place so that cached geometry is rebuilt
 		void setShape(Shape* shape);
 
 		BodyType type() const;
@@ -76,6 +89,7 @@ namespace Physics2D
 
 		real inertia() const;
 
+		//the tight box is cached until position, rotation or shape change, see setShape
 		AABB aabb(const real& factor = Constant::AABBExpansionFactor) const;
 
 		real friction() const;
@@ -93,6 +107,7 @@ namespace Physics2D
 		void stepPosition(const real& dt);
 
 		void applyImpulse(const Vector2& impulse, const Vector2& r);
+		void applyPositionImpulse(const Vector2& impulse, const Vector2& r);
 		Vector2 toLocalPoint(const Vector2& point) const;
 		Vector2 toWorldPoint(const Vector2& point) const;
 		Vector2 toActualPoint(const Vector2& point) const;
@@ -108,36 +123,76 @@ namespace Physics2D
 
 		real kineticEnergy() const;
 
+		//slot of this body in its store, changes when another body is removed
+		Index storeIndex() const;
+		//changes whenever the pose or the shape of the body changes, see BodyStore::updateTransformStamps
+		uint32_t transformStamp() const;
+
 	private:
+		friend struct BodyStore;
 		void calcInertia();
 
-		uint32_t m_id;
+		//hot state lives in the store, see BodyStore
+		BodyStore* m_store = nullptr;
+		Index m_index = 0;
+		std::unique_ptr<BodyStore> m_localStore;
+
+		uint32_t m_id = 0;
 		uint32_t m_bitmask = 1;
 
 		real m_mass = 0;
 		real m_inertia = 0;
-		real m_invMass = 0;
-		real m_invInertia = 0;
-
-		Vector2 m_position;
-		Vector2 m_velocity;
-		real m_rotation = 0;
-		real m_angularVelocity = 0;
 
-		Vector2 m_lastPosition;
-		real m_lastRotation = 0;
+		Shape* m_shape = nullptr;
 
-		Vector2 m_forces;
-		real m_torques = 0;
+		//tight box of the pose it was computed for
+		mutable AABB m_aabb;
+		mutable Vector2 m_aabbPosition;
+		mutable real m_aabbRotation = std::numeric_limits<real>::quiet_NaN();
 
-		Shape* m_shape;
-		BodyType m_type = BodyType::Static;
-
-		bool m_sleep = false;
 		real m_friction = 0.1f;
 		real m_restitution = 0.0f;
 
 		uint32_t m_sleepCountdown = 0;
 	};
+
+	/// <summary>
+	/// Structure of arrays holding the per-step state of bodies.
+	/// Slot i of every array belongs to body[i]. Removing a slot moves the last one into it,
+	/// so Body* is the stable handle and the index is only valid until the next remove.
+	/// </summary>
+	struct PHYSICS2D_API BodyStore
+	{
+		Index add(Body* body);
+		void remove(const Index& index);
+		void clear();
+		size_t size() const;
+		//rebuilds the rotation matrices of all bodies whose rotation changed.
+		//called once before every parallel phase so that the lazy rebuild in Body::rotationMatrix never writes there
+		void updateRotations();
+		//bumps the transform stamp of every body whose position or rotation changed since the last call
+		void updateTransformStamps();
+
+		Container::Vector<Vector2> position;
+		Container::Vector<Vector2> velocity;
+		Container::Vector<real> rotation;
+		//cos and sin of rotation, matrixRotation is the angle they were built for
+		Container::Vector<Matrix2x2> rotationMatrix;
+		Container::Vector<real> matrixRotation;
+		Container::Vector<real> angularVelocity;
+		Container::Vector<Vector2> forces;
+		Container::Vector<real> torques;
+		Container::Vector<real> inverseMass;
+		Container::Vector<real> inverseInertia;
+		Container::Vector<Vector2> lastPosition;
+		Container::Vector<real> lastRotation;
+		Container::Vector<Body::BodyType> type;
+		Container::Vector<uint8_t> sleep;
+		//pose of the last updateTransformStamps and the stamp it was given
+		Container::Vector<Vector2> stampPosition;
+		Container::Vector<real> stampRotation;
+		Container::Vector<uint32_t> transformStamp;
+		Container::Vector<Body*> body;
+	};
 }
 #endif
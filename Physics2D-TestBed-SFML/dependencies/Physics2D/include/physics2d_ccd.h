@@ -10,27 +10,30 @@ namespace Physics2D
 {
 	/// <summary>
 	/// Continuous Collision Detection
-	///	This class is implemented by bisection and re-sampling. Both them are costly.
+	///	Time of impact is found by conservative advancement on gjk distance queries. Bodies are never moved,
+	///	the shapes are placed at interpolated transforms instead.
 	/// </summary>
 	class PHYSICS2D_API CCD
 	{
 	public:
-		struct PHYSICS2D_API AABBShot
+		/// <summary>
+		/// Motion of a body over one step at constant velocity, the same motion stepPosition integrates.
+		/// </summary>
+		struct PHYSICS2D_API Sweep
 		{
-			AABBShot(const AABB& box, const Body::PhysicsAttribute& attr, const real& t) : aabb(box), attribute(attr),
-				time(t)
-			{
-			}
+			Shape* shape = nullptr;
+			Vector2 position;
+			Vector2 velocity;
+			real rotation = 0;
+			real angularVelocity = 0;
+			//no point of the shape is further from the body position, bounds how fast rotation moves a point.
+			//zero for shapes that rotation does not move
+			real radius = 0;
 
-			AABB aabb;
-			Body::PhysicsAttribute attribute;
-			real time = 0;
-		};
-
-		struct PHYSICS2D_API IndexSection
-		{
-			int forward = -1;
-			int backward = -1;
+			static Sweep fromBody(Body* body);
+			ShapePrimitive at(const real& t) const;
+			//the box the shape covers over [0, dt]
+			AABB aabb(const real& dt) const;
 		};
 
 		struct PHYSICS2D_API CCDPair
@@ -45,21 +48,27 @@ namespace Physics2D
 			Body* body = nullptr;
 		};
 
-		using BroadphaseTrajectory = Container::Vector<AABBShot>;
-		static std::tuple<BroadphaseTrajectory, AABB> buildTrajectoryAABB(Body* body, const real& dt);
-		static std::tuple<Container::Vector<AABBShot>, AABB> buildTrajectoryAABB(
-			Body* body, const Vector2& target, const real& dt);
-		static std::optional<IndexSection> findBroadphaseRoot(Body* staticBody,
-		                                                      const BroadphaseTrajectory& staticTrajectory,
-		                                                      Body* dynamicBody,
-		                                                      const BroadphaseTrajectory& dynamicTrajectory,
-		                                                      const real& dt);
-		static std::optional<real> findNarrowphaseRoot(Body* staticBody, const BroadphaseTrajectory& staticTrajectory,
-		                                               Body* dynamicBody, const BroadphaseTrajectory& dynamicTrajectory,
-		                                               const IndexSection& index, const real& dt);
+		/// <summary>
+		/// Conservative advancement. Every iteration measures the distance at the current time and advances by
+		/// the longest time in which the closing speed bound cannot cover it, so the shapes never pass through
+		/// each other. Near touching it steps at most Constant::CCDPenetration into the overlap until a contact
+		/// is made, or gives up after Constant::CCDMaxIterations queries. A pair that gave up returns the time it
+		/// reached, where the shapes may still be apart, so the caller moves it there and looks again from it.
+		/// </summary>
+		/// <param name="sweepA"></param>
+		/// <param name="sweepB"></param>
+		/// <param name="dt"></param>
+		/// <param name="queries">distance queries spent are added to it when given</param>
+		/// <returns>time in [0, dt] when the shapes overlap by at most Constant::CCDPenetration, the time reached
+		/// when the queries ran out, zero if they already overlap and keep closing, nothing if they stay apart
+		/// or separate</returns>
+		static std::optional<real> timeOfImpact(const Sweep& sweepA, const Sweep& sweepB, const real& dt,
+		                                        size_t* queries = nullptr);
 
-		static std::optional<Container::Vector<CCDPair>> query(Tree& tree, Body* body, const real& dt);
-		static std::optional<Container::Vector<CCDPair>> query(UniformGrid& grid, Body* body, const real& dt);
+		static std::optional<Container::Vector<CCDPair>> query(Tree& tree, Body* body, const real& dt,
+		                                                       size_t* queries = nullptr);
+		static std::optional<Container::Vector<CCDPair>> query(UniformGrid& grid, Body* body, const real& dt,
+		                                                       size_t* queries = nullptr);
 		static std::optional<real> earliestTOI(const Container::Vector<CCDPair>& pairs,
 		                                       const real& epsilon = Constant::GeometryEpsilon);
 	};
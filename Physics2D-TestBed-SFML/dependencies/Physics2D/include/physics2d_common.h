@@ -12,6 +12,8 @@
 #include <functional>
 #include <memory>
 #include <map>
+#include <list>
+#include <array>
 #include <iostream>
 
 
@@ -44,7 +46,8 @@ namespace Physics2D
 	namespace Constant
 	{
 		constexpr unsigned int SimplexMax = 8;
-		constexpr unsigned int CCDMaxIterations = 20;
+		constexpr unsigned int CCDMaxIterations = 50;
+		constexpr unsigned int CCDMaxSubSteps = 8;
 		constexpr real Epsilon = FLT_EPSILON;
 		constexpr real Max = FLT_MAX;
 		constexpr real PositiveMin = FLT_MIN;
@@ -56,6 +59,10 @@ namespace Physics2D
 		constexpr real GeometryEpsilon = 1e-6f;
 		constexpr real TrignometryEpsilon = 1e-3f;
 		constexpr real CCDMinVelocity = 100.0f;
+		constexpr real CCDTolerance = 0.005f;
+		constexpr real CCDPenetration = 0.01f;
+		//gap a speculative contact leaves between the shapes, so that the next step still finds them apart
+		constexpr real SpeculativeGap = 0.001f;
 		constexpr real MaxVelocity = 1000.0f;
 		constexpr real MaxAngularVelocity = 1000.0f;
 		constexpr real AABBExpansionFactor = 0.0f;
@@ -64,6 +71,7 @@ namespace Physics2D
 		constexpr real MinEnergy = 9e-10f;
 		constexpr size_t SleepCountdown = 32;
 		constexpr int GJKRetryTimes = 8;
+		constexpr size_t ProfileHistoryCount = 120;
 	}
 #else
 	using real = double;
@@ -79,13 +87,19 @@ namespace Physics2D
 		constexpr real DoublePi = Constant::Pi * 2.0;
 		constexpr real ReciprocalOfPi = 0.3183098861837907;
 		constexpr real GeometryEpsilon = 0.0000001;
+		constexpr unsigned int CCDMaxIterations = 50;
+		constexpr unsigned int CCDMaxSubSteps = 8;
 		constexpr real CCDMinVelocity = 100.0;
+		constexpr real CCDTolerance = 0.005;
+		constexpr real CCDPenetration = 0.01;
+		constexpr real SpeculativeGap = 0.001;
 		constexpr real MaxVelocity = 1000.0;
 		constexpr real MaxAngularVelocity = 1000.0;
 		constexpr real AABBExpansionFactor = 0.0;
 		constexpr real MinLinearVelocity = 1e-4;
 		constexpr real MinAngularVelocity = 1e-4;
 		constexpr size_t SleepCountdown = 32;
+		constexpr size_t ProfileHistoryCount = 120;
 
 	}
 #endif
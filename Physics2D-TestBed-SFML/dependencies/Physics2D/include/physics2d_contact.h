@@ -5,6 +5,7 @@
 #include "physics2d_body.h"
 #include "physics2d_random.h"
 #include "physics2d_detector.h"
+#include "physics2d_simd.h"
 
 namespace Physics2D
 {
@@ -34,6 +35,8 @@ namespace Physics2D
 	{
 		ContactConstraintPoint() = default;
 		Body::BodyPair::BodyPairID relation = 0;
+		//feature id of the point, see ContactPair::ids
+		uint64_t id = 0;
 		real friction = 0.2f;
 		bool active = true;
 		Vector2 localA;
@@ -45,6 +48,109 @@ namespace Physics2D
 		Matrix2x2 normalMass;
 	};
 
+	/// <summary>
+	/// Contact points of one body pair, stored inline.
+	/// Behaves like a small vector so that solvers can loop over it directly.
+	/// </summary>
+	struct PHYSICS2D_API ContactManifold
+	{
+		static constexpr size_t Capacity = 2;
+
+		ContactConstraintPoint* begin();
+		ContactConstraintPoint* end();
+		const ContactConstraintPoint* begin() const;
+		const ContactConstraintPoint* end() const;
+		ContactConstraintPoint& operator[](size_t index);
+		const ContactConstraintPoint& operator[](size_t index) const;
+		ContactConstraintPoint& front();
+		const ContactConstraintPoint& front() const;
+		size_t size() const;
+		bool empty() const;
+		ContactConstraintPoint& emplace_back(const ContactConstraintPoint& ccp);
+
+		Body::BodyPair::BodyPairID relation = 0;
+		uint32_t count = 0;
+		ContactConstraintPoint points[Capacity];
+	};
+
+	/// <summary>
+	/// Open addressing hash index from pair id to manifold slot, linear probing with backward shift deletion.
+	/// </summary>
+	class PHYSICS2D_API ContactIndex
+	{
+	public:
+		static constexpr Index InvalidSlot = std::numeric_limits<Index>::max();
+
+		Index find(const Body::BodyPair::BodyPairID& relation) const;
+		void insert(const Body::BodyPair::BodyPairID& relation, Index slot);
+		void erase(const Body::BodyPair::BodyPairID& relation);
+		void clear();
+
+	private:
+		struct Entry
+		{
+			Body::BodyPair::BodyPairID relation = 0;
+			Index slot = InvalidSlot;
+		};
+		size_t home(const Body::BodyPair::BodyPairID& relation) const;
+		void grow();
+
+		Container::Vector<Entry> m_entries;
+		size_t m_count = 0;
+	};
+
+	/// <summary>
+	/// Up to four manifolds that share no written body, copied into lanes and solved in lockstep.
+	/// Lane i holds both points of manifold i. Missing points and lanes are zero, so they never produce an impulse.
+	/// </summary>
+	struct PHYSICS2D_API WideContactConstraint
+	{
+		static constexpr size_t LaneCount = 4;
+		static constexpr size_t PointCount = 2;
+
+		size_t laneCount = 0;
+		Index bodyA[LaneCount] = {};
+		Index bodyB[LaneCount] = {};
+		//bodies without inverse mass and inertia are read but never written back
+		bool writeA[LaneCount] = {};
+		bool writeB[LaneCount] = {};
+		ContactConstraintPoint* points[PointCount][LaneCount] = {};
+
+		alignas(16) float inverseMassA[LaneCount] = {};
+		alignas(16) float inverseInertiaA[LaneCount] = {};
+		alignas(16) float inverseMassB[LaneCount] = {};
+		alignas(16) float inverseInertiaB[LaneCount] = {};
+		alignas(16) float normalX[LaneCount] = {};
+		alignas(16) float normalY[LaneCount] = {};
+		alignas(16) float tangentX[LaneCount] = {};
+		alignas(16) float tangentY[LaneCount] = {};
+		alignas(16) float friction[LaneCount] = {};
+
+		alignas(16) float raX[PointCount][LaneCount] = {};
+		alignas(16) float raY[PointCount][LaneCount] = {};
+		alignas(16) float rbX[PointCount][LaneCount] = {};
+		alignas(16) float rbY[PointCount][LaneCount] = {};
+		alignas(16) float bias[PointCount][LaneCount] = {};
+		alignas(16) float effectiveMassNormal[PointCount][LaneCount] = {};
+		alignas(16) float effectiveMassTangent[PointCount][LaneCount] = {};
+		alignas(16) float normalImpulse[PointCount][LaneCount] = {};
+		alignas(16) float tangentImpulse[PointCount][LaneCount] = {};
+	};
+
+	/// <summary>
+	/// Coefficients of a contact treated as a damped spring over one sub-step, as in box2d v3.
+	/// The spring pushes the bodies apart at biasRate times the penetration, massScale and impulseScale
+	/// soften the impulse so that a stack settles instead of being driven apart.
+	/// </summary>
+	struct PHYSICS2D_API ContactSoftness
+	{
+		real biasRate = 0;
+		real massScale = 1;
+		real impulseScale = 0;
+
+		static ContactSoftness make(const real& hertz, const real& dampingRatio, const real& h);
+	};
+
 	class PHYSICS2D_API ContactMaintainer
 	{
 	public:
@@ -52,19 +158,52 @@ namespace Physics2D
 		void solveVelocity(real dt);
 		void solveRestitution(real dt);
 		void solvePosition(real dt);
+		//solve a single manifold of the contact table, used by the island solver
+		void solveVelocity(ContactManifold& contactList, real dt);
+		void solveRestitution(ContactManifold& contactList, real dt);
+		void solvePosition(ContactManifold& contactList, real dt);
+		//wide path, the manifolds of one constraint must not share a written body
+		void prepare(WideContactConstraint& wide, ContactManifold* const* contactLists, size_t count) const;
+		void solveVelocity(WideContactConstraint& wide, BodyStore& store) const;
+		//copy the accumulated impulses back for warm starting and drawing
+		void storeImpulses(const WideContactConstraint& wide) const;
+		//soft step, see PhysicsSystem::softStep. The softness of the sub-step h is set once per step,
+		//then every sub-step warm starts the manifolds, solves them with the bias and relaxes them without it
+		void prepareSoftStep(real h);
+		void warmStart(ContactManifold& contactList);
+		void solveSoft(ContactManifold& contactList, real h, bool useBias);
 		void add(const Collision& collision);
 		void prepare(ContactConstraintPoint& ccp, const VertexPair& pair, const Collision& collision);
 		void clearInactivePoints();
 		void deactivateAllPoints();
+		//keep the manifold of a pair that is not detected this step, returns false if there is none
+		bool keepAlive(const Body::BodyPair::BodyPairID& relation);
+		ContactManifold* find(const Body::BodyPair::BodyPairID& relation);
+		size_t contactPointCount() const;
 
 		real m_maxPenetration = 0.005f;
 		real m_biasFactor = 0.15f;
 		bool m_warmStart = true;
 		bool m_velocityBlockSolver = true;
 		bool m_positionBlockSolver = true;
-		Container::Map<Body::BodyPair::BodyPairID, Container::Vector<ContactConstraintPoint>> m_contactTable;
+		//solve colored islands four manifolds at a time, points are solved one by one without the block solver
+		bool m_wideVelocitySolver = false;
+		//step of the positions that follow the velocity solve. When it is set, points whose bodies are still apart
+		//are speculative, see Detector::speculate. 0 treats every point as touching
+		real m_speculativeDeltaTime = 0;
+		//stiffness of the soft step contacts, it is lowered to a quarter of the sub-step rate when that is slower.
+		//contacts with a static body are twice as stiff
+		real m_contactHertz = 30.0f;
+		real m_contactDampingRatio = 10.0f;
+		//fastest the soft step pushes penetrating bodies apart
+		real m_maxPushVelocity = 3.0f;
+		//manifolds of every touching pair in one dense array, expired manifolds are swap-removed
+		Container::Vector<ContactManifold> m_contactTable;
 
 	private:
+		ContactIndex m_contactIndex;
+		ContactSoftness m_softness;
+		ContactSoftness m_staticSoftness;
 	};
 }
 #endif
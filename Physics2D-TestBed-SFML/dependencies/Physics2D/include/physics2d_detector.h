@@ -26,10 +26,21 @@ namespace Physics2D
 		static bool collide(const ShapePrimitive& shapeA, Body* bodyB);
 		static bool collide(Body* bodyA, const ShapePrimitive& shapeB);
 
-		static Collision detect(Body* bodyA, Body* bodyB);
-		static Collision detect(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB);
+		//cache carries the narrowphase state of the pair from one step to the next, see CollisionCache.
+		//with analytic circle, capsule and polygon pairs get their contacts analytically, everything else goes
+		//through gjk and epa. turn it off to send every pair through gjk and epa.
+		//with typed the pairs left to gjk and epa run a kernel compiled for their two shape types, see
+		//Narrowphase::collideKernel. turn it off to find support points through the type switch instead
+		static Collision detect(Body* bodyA, Body* bodyB, CollisionCache* cache = nullptr, bool analytic = true,
+		                        bool typed = true);
+		static Collision detect(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
+		                        CollisionCache* cache = nullptr, bool analytic = true, bool typed = true);
 		static Collision detect(Body* bodyA, const ShapePrimitive& shapeB);
 		static Collision detect(const ShapePrimitive& shapeA, Body* bodyB);
+		//contacts of a pair that is apart by less than margin, for speculative contacts. The points are where the shapes
+		//would touch if they closed the gap along the normal, penetration is minus the gap.
+		//nothing if the shapes overlap or the gap is at least margin
+		static Collision speculate(Body* bodyA, Body* bodyB, const real& margin);
 
 		static CollisionInfo distance(Body* bodyA, Body* bodyB);
 		static CollisionInfo distance(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB);
@@ -37,6 +48,9 @@ namespace Physics2D
 		static CollisionInfo distance(const ShapePrimitive& shapeA, Body* bodyB);
 
 	private:
+		//false if the pair has no analytic path and must fall back to gjk and epa
+		static bool detectAnalytic(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, Collision& result,
+		                           CollisionCache* cache);
 	};
 }
 #endif
@@ -172,6 +172,14 @@ namespace Physics2D
 
 		}
 
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
+		}
 		DistanceJointPrimitive& primitive()
 		{
 			return m_primitive;
@@ -0,0 +1,69 @@
+#ifndef PHYSICS2D_ISLAND_H
+#define PHYSICS2D_ISLAND_H
+#include "physics2d_world.h"
+#include "physics2d_contact.h"
+
+namespace Physics2D
+{
+	/// <summary>
+	/// Constraints of one island partitioned so that no two constraints of a color write the same body.
+	/// Every color can be solved in parallel, colors themselves are solved one after another.
+	/// </summary>
+	struct PHYSICS2D_API ConstraintColors
+	{
+		Container::Vector<Container::Vector<ContactManifold*>> contacts;
+		Container::Vector<Container::Vector<Joint*>> joints;
+		//constraints that did not fit into any color, solved on one thread after the colors
+		Container::Vector<ContactManifold*> contactOverflow;
+		Container::Vector<Joint*> jointOverflow;
+		//contacts of every color packed four manifolds at a time for the wide velocity solver
+		Container::Vector<Container::Vector<WideContactConstraint>> wideContacts;
+	};
+
+	/// <summary>
+	/// Bodies that are connected through touching contacts or joints in the current step.
+	/// Static bodies and bodies with zero inverse mass never link two islands together,
+	/// their contacts and joints belong to the island of the other body.
+	/// </summary>
+	struct PHYSICS2D_API Island
+	{
+		Container::Vector<Body*> bodies;
+		Container::Vector<ContactManifold*> contacts;
+		Container::Vector<Joint*> joints;
+		bool sleep = false;
+		//set when the island is solved color by color instead of as a whole
+		bool colored = false;
+		ConstraintColors colors;
+	};
+
+	/// <summary>
+	/// Rebuilds islands every step with union-find over the body store.
+	/// An island is the unit of sleeping: it falls asleep when every body in it has been still for
+	/// Constant::SleepCountdown steps, and wakes as a whole as soon as one of its bodies is touched or moved.
+	/// </summary>
+	class PHYSICS2D_API IslandBuilder
+	{
+	public:
+		void build(PhysicsWorld& world, ContactMaintainer& maintainer);
+		//greedy graph coloring of the island constraints, see ConstraintColors
+		void color(Island& island, BodyStore& store);
+		Container::Vector<Island>& islands();
+		size_t awakeCount() const;
+		//static bodies and bodies with zero inverse mass are shared between islands instead of linking them
+		static bool linkable(Body* body);
+
+	private:
+		Index find(Index index);
+		void unite(Index a, Index b);
+		bool linkable(const BodyStore& store, const Index& index) const;
+
+		Container::Vector<Index> m_parent;
+		//island index of every root, InvalidIsland for bodies that are not linkable
+		Container::Vector<Index> m_islandIndex;
+		Container::Vector<Island> m_islands;
+		//colors already taken by the constraints of every body while coloring, bit i is color i
+		Container::Vector<uint64_t> m_colorMask;
+		size_t m_awakeCount = 0;
+	};
+}
+#endif
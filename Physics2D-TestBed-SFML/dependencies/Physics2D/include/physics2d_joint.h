@@ -24,6 +24,9 @@ namespace Physics2D
 		virtual void prepare(const real& dt) = 0;
 		virtual void solveVelocity(const real& dt) = 0;
 		virtual void solvePosition(const real& dt) = 0;
+		//bodies the joint acts on, bodyB is nullptr for single body joints
+		virtual Body* bodyA() const = 0;
+		virtual Body* bodyB() const = 0;
 		bool active()
 		{
 			return m_active;
@@ -3,6 +3,7 @@
 #include "physics2d_common.h"
 #include "physics2d_shape.h"
 #include "physics2d_simplex.h"
+#include <type_traits>
 
 #include "physics2d_capsule.h"
 #include "physics2d_circle.h"
@@ -22,6 +23,35 @@ namespace Physics2D
 		real distance = 0.0f;
 	};
 
+	/// <summary>
+	/// Convex polytope expanded by epa and gjk distance, a ring of vertices in a fixed array.
+	/// Every vertex stores the squared distance from the origin to the edge that starts at it.
+	/// Slots are constructed when they are written, a polytope rarely grows past a few vertices.
+	/// </summary>
+	class PHYSICS2D_API Polytope
+	{
+	public:
+		static constexpr size_t Capacity = 64;
+
+		void build(const Simplex& simplex);
+		size_t next(size_t index) const;
+		size_t prev(size_t index) const;
+		//insert between prev(index) and index, the indices before index stay valid
+		void insert(size_t index, const SimplexVertexWithOriginDistance& vertex);
+		bool full() const;
+		size_t size() const;
+		SimplexVertexWithOriginDistance& operator[](size_t index);
+		const SimplexVertexWithOriginDistance& operator[](size_t index) const;
+
+	private:
+		static_assert(std::is_trivially_destructible_v<SimplexVertexWithOriginDistance>);
+		SimplexVertexWithOriginDistance* slots();
+		const SimplexVertexWithOriginDistance* slots() const;
+
+		alignas(SimplexVertexWithOriginDistance) unsigned char m_storage[Capacity * sizeof(SimplexVertexWithOriginDistance)];
+		size_t m_count = 0;
+	};
+
 	struct PHYSICS2D_API Feature
 	{
 		//circle and ellipse, use index 0
@@ -48,12 +78,15 @@ namespace Physics2D
 		//	points[2]: pointA
 		//	points[3]: pointB
 		std::array<Vector2, 4> points;
-		std::array<uint64_t, 2> ids;
+		//ids[i] names the features that produced contact pair i. The same features touching in two steps
+		//give the same id, the contact maintainer hands accumulated impulses over by it
+		std::array<uint64_t, 2> ids = {};
 		uint32_t count = 0;
 
-		void addContact(const Vector2& pointA, const Vector2& pointB)
+		void addContact(const Vector2& pointA, const Vector2& pointB, uint64_t id = 0)
 		{
 			assert(count <= 4);
+			ids[count / 2] = id;
 			points[count++] = pointA;
 			points[count++] = pointB;
 		}
@@ -86,7 +119,69 @@ namespace Physics2D
 		VertexPair pair;
 		//[Debug]
 		Simplex originalSimplex;
-		std::list<SimplexVertexWithOriginDistance> polytope;
+		//final polytope, only filled when asked for
+		Container::Vector<SimplexVertexWithOriginDistance> polytope;
+	};
+
+	/// <summary>
+	/// What the narrowphase found for a pair in the last step, kept by the broadphase for as long as the pair overlaps.
+	/// Resting and slowly moving pairs end up with nearly the same simplex and separating face every step,
+	/// so gjk starts from the vertices of its last simplex and the hull test checks the last separating face first.
+	/// </summary>
+	struct PHYSICS2D_API CollisionCache
+	{
+		//polygon vertex indices of the simplex that contained the origin, A then B. Empty if it had other vertices
+		Index simplexIndex[3][2] = {};
+		size_t simplexCount = 0;
+		//last search direction of gjk, the first direction of the next run
+		Vector2 axis;
+		bool hasAxis = false;
+		//support vertices of A and B along axis, where the hill climbing of large polygons starts next time
+		Index supportIndex[2] = {UINT32_MAX, UINT32_MAX};
+		//face of the analytic hull test with the largest separation, hull 0 is shape A and 1 is shape B
+		Index separatingHull = 0;
+		Index separatingFace = UINT32_MAX;
+		//set by every detection that ran gjk, for profiling
+		bool gjk = false;
+		uint32_t iterations = 0;
+
+		//result of the last detection and the transform stamps of both bodies it was computed for.
+		//the broadphase reuses it as long as neither body has moved, see Body::transformStamp
+		bool detected = false;
+		bool reused = false;
+		uint32_t transformStamp[2] = {};
+		bool colliding = false;
+		ContactPair contacts;
+		Vector2 normal;
+		real penetration = 0;
+		//set when the batched gjk proved the pair apart in this step, see Narrowphase::gjkSeparated
+		bool rejected = false;
+	};
+
+	/// <summary>
+	/// Up to four pairs for Narrowphase::gjkSeparated in structure of arrays form, one pair per SIMD lane.
+	/// Every shape is reduced to a convex core in world space and a radius: polygons and edges keep their vertices,
+	/// a capsule becomes its segment and a circle its center. Lanes with fewer vertices repeat their last one.
+	/// </summary>
+	struct PHYSICS2D_API GjkBatch
+	{
+		static constexpr size_t LaneCount = 4;
+		static constexpr size_t MaxVertices = 8;
+
+		alignas(16) float ax[MaxVertices][LaneCount] = {};
+		alignas(16) float ay[MaxVertices][LaneCount] = {};
+		alignas(16) float bx[MaxVertices][LaneCount] = {};
+		alignas(16) float by[MaxVertices][LaneCount] = {};
+		//sum of the radii of both shapes
+		alignas(16) float radius[LaneCount] = {};
+		//largest vertex count of all lanes
+		size_t countA = 0;
+		size_t countB = 0;
+		size_t size = 0;
+
+		//false if a shape has no core that fits, the pair is left to the scalar path
+		bool add(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB);
+		void clear();
 	};
 
 	class PHYSICS2D_API Narrowphase
@@ -94,24 +189,69 @@ namespace Physics2D
 	public:
 		static Simplex gjk(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, const size_t& iteration = 30);
 		static CollisionInfo epa(const Simplex& simplex, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-		                         const size_t& iteration = 30, const real& epsilon = Constant::GeometryEpsilon);
+		                         const size_t& iteration = 30, const real& epsilon = Constant::GeometryEpsilon,
+		                         bool capturePolytope = false);
 		static SimplexVertex support(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
 		                             const Vector2& direction);
-		static std::pair<Vector2, Index> findFurthestPoint(const ShapePrimitive& shape, const Vector2& direction);
+		//start is a support index of an earlier direction for large polygons to climb from, see below
+		static std::pair<Vector2, Index> findFurthestPoint(const ShapePrimitive& shape, const Vector2& direction,
+		                                                   Index start = UINT32_MAX);
 		static Vector2 findDirectionByEdge(const SimplexVertex& v1, const SimplexVertex& v2, bool pointToOrigin);
 		static std::pair<Vector2, Index> findFurthestPoint(const Container::Vector<Vector2>& vertices,
 		                                                   const Vector2& direction);
+		//support vertex of a polygon in its local space. Polygons with fewer than HillClimbingVertexCount
+		//vertices are scanned with SIMD, larger ones climb from start to the neighbor that lies further
+		//until none does. Without a valid start they are scanned as well
+		static constexpr size_t HillClimbingVertexCount = 16;
+		static std::pair<Vector2, Index> findFurthestPoint(const Polygon& polygon, const Vector2& direction,
+		                                                   Index start = UINT32_MAX);
+		//every vertex four at a time, ties go to the lowest index like the linear scan
+		static std::pair<Vector2, Index> findFurthestPointByScan(const Polygon& polygon, const Vector2& direction);
+		static std::pair<Vector2, Index> findFurthestPointByClimbing(const Polygon& polygon, const Vector2& direction,
+		                                                             Index start);
 		static ContactPair generateContacts(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
 		                                    CollisionInfo& info);
 
 		static CollisionInfo gjkDistance(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-		                                 const size_t& iteration = 10);
+		                                 const size_t& iteration = 10, bool capturePolytope = false);
+
+		//gjk distance of every lane of the batch at once, used to reject broadphase pairs before contact generation.
+		//separated[i] is true only if the cores of lane i are certainly further apart than its radius.
+		//overlapping, touching and undecided lanes are false and need the full narrowphase
+		static void gjkSeparated(const GjkBatch& batch, bool* separated, const size_t& iteration = 20);
+
+		//gjk, epa and contact generation of one pair, false if the shapes do not penetrate.
+		//cache is read to warm start gjk and updated afterwards, nullptr to start cold
+		using CollideKernel = bool (*)(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
+		                               CollisionInfo& info, ContactPair& contacts, CollisionCache* cache);
+		//kernel with the support functions of both shape types inlined, pick it once per pair
+		static CollideKernel collideKernel(ShapeType typeA, ShapeType typeB);
+		//same as the kernels but finds the support functions through the type switch of findFurthestPoint
+		static bool collide(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, CollisionInfo& info,
+		                    ContactPair& contacts, CollisionCache* cache = nullptr);
 
 	private:
+		//the templates below are only instantiated in the source file, Support provides
+		//support(shapeA, shapeB, direction) and remembers the last support vertices to climb from.
+		//ShapeA and ShapeB are concrete shapes or Shape for the type switch
+		template <typename ShapeA, typename ShapeB>
+		static bool collide(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, CollisionInfo& info,
+		                    ContactPair& contacts, CollisionCache* cache);
+
+		template <typename Support>
+		static Simplex gjkKernel(Support& support, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
+		                         const size_t& iteration, CollisionCache* cache = nullptr);
+
+		template <typename Support>
+		static CollisionInfo epaKernel(Support& support, const Simplex& simplex, const ShapePrimitive& shapeA,
+		                               const ShapePrimitive& shapeB, const size_t& iteration, const real& epsilon,
+		                               bool capturePolytope);
+
 		static void reconstructSimplexByVoronoi(Simplex& simplex);
 
-		static bool perturbSimplex(Simplex& simplex, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-		                           const Vector2& dir);
+		template <typename Support>
+		static bool perturbSimplex(Support& support, Simplex& simplex, const ShapePrimitive& shapeA,
+		                           const ShapePrimitive& shapeB, const Vector2& dir);
 
 		static Feature findFeatures(const Simplex& simplex, const Vector2& normal, const ShapePrimitive& shape,
 		                            const Index& AorB);
@@ -147,13 +287,7 @@ namespace Physics2D
 		static ContactPair clipEdgeVertex(const Vector2& va1, const Vector2& va2, const Vector2& vb,
 		                                  CollisionInfo& info);
 
-		static void polytopeIterNext(std::list<SimplexVertexWithOriginDistance>::iterator& targetIter,
-		                             std::list<SimplexVertexWithOriginDistance>& list);
-		static void polytopeIterPrev(std::list<SimplexVertexWithOriginDistance>::iterator& targetIter,
-		                             std::list<SimplexVertexWithOriginDistance>& list);
-
-		static void buildPolytopeFromSimplex(std::list<SimplexVertexWithOriginDistance>& polytope,
-		                                     const Simplex& simplex);
+		static void capture(const Polytope& polytope, CollisionInfo& info);
 	};
 }
 #endif
@@ -137,6 +137,14 @@ namespace Physics2D
 
 		}
 
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return nullptr;
+		}
 		PathJointPrimitive& primitive()
 		{
 			return m_primitive;
@@ -123,6 +123,14 @@ namespace Physics2D
 		{
 		}
 
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return nullptr;
+		}
 		PointJointPrimitive& primitive()
 		{
 			return m_primitive;
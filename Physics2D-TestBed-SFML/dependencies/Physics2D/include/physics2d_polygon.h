@@ -1,6 +1,7 @@
 #ifndef PHYSICS2D_SHAPE_POLYGON_H
 #define PHYSICS2D_SHAPE_POLYGON_H
 #include "physics2d_shape.h"
+#include "physics2d_simd.h"
 namespace Physics2D
 {
     class PHYSICS2D_API Polygon : public Shape
@@ -10,6 +11,11 @@ namespace Physics2D
         Polygon();
 
         const Container::Vector<Vector2>& vertices() const;
+        //outward unit normal of the edge from vertex i to vertex i + 1, zero if the edge has no length
+        const Container::Vector<Vector2>& normals() const;
+        //vertex coordinates four at a time for the SIMD support scan, the last block repeats the last vertex
+        const Container::Vector<Float4>& laneX() const;
+        const Container::Vector<Float4>& laneY() const;
         void append(const std::initializer_list<Vector2>& vertices);
         void append(const Vector2& vertex);
         Vector2 center()const override;
@@ -17,7 +23,12 @@ namespace Physics2D
         bool contains(const Vector2& point, const real& epsilon = Constant::GeometryEpsilon) override;
     protected:
         Container::Vector<Vector2> m_vertices;
+        Container::Vector<Vector2> m_normals;
+        Container::Vector<Float4> m_laneX;
+        Container::Vector<Float4> m_laneY;
         void updateVertices();
+        void updateNormals();
+        void updateLanes();
     };
 }
 #endif
\ No newline at end of file
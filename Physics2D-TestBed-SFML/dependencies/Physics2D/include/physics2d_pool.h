@@ -0,0 +1,129 @@
+#ifndef PHYSICS2D_POOL_H
+#define PHYSICS2D_POOL_H
+#include <new>
+#include "physics2d_common.h"
+
+namespace Physics2D
+{
+	/// <summary>
+	/// Deleter that hands an object back to the pool it came from.
+	/// Base may be a base class of the pooled type, the pool casts back before destroying.
+	/// </summary>
+	template <typename Base>
+	struct PoolDeleter
+	{
+		void (*destroy)(void* pool, Base* object) = nullptr;
+		void* pool = nullptr;
+
+		void operator()(Base* object) const
+		{
+			if (object != nullptr)
+				destroy(pool, object);
+		}
+	};
+
+	template <typename T>
+	using PoolPtr = std::unique_ptr<T, PoolDeleter<T>>;
+
+	/// <summary>
+	/// Fixed-size block allocator. Objects never move, freed slots are reused through an intrusive free list,
+	/// and blocks are kept until the pool is released so that reloading a scene does not hit malloc again.
+	/// </summary>
+	template <typename T, size_t BlockSize = 256>
+	class ObjectPool
+	{
+	public:
+		ObjectPool() = default;
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		~ObjectPool()
+		{
+			assert(m_count == 0 && "Destroying a pool with live objects.");
+			release();
+		}
+
+		template <typename... Args>
+		T* create(Args&&... args)
+		{
+			if (m_freeList == nullptr)
+				grow();
+
+			Slot* slot = m_freeList;
+			m_freeList = slot->next;
+			++m_count;
+			return new(slot->storage) T(std::forward<Args>(args)...);
+		}
+
+		void destroy(T* object)
+		{
+			assert(object != nullptr);
+			object->~T();
+			Slot* slot = reinterpret_cast<Slot*>(object);
+			slot->next = m_freeList;
+			m_freeList = slot;
+			--m_count;
+		}
+
+		template <typename Base = T>
+		PoolDeleter<Base> deleter()
+		{
+			return PoolDeleter<Base>{
+				[](void* pool, Base* object)
+				{
+					static_cast<ObjectPool*>(pool)->destroy(static_cast<T*>(object));
+				},
+				this
+			};
+		}
+
+		template <typename Base = T, typename... Args>
+		PoolPtr<Base> make(Args&&... args)
+		{
+			return PoolPtr<Base>(create(std::forward<Args>(args)...), deleter<Base>());
+		}
+
+		//free every block, all objects must have been destroyed
+		void release()
+		{
+			assert(m_count == 0 && "Releasing a pool with live objects.");
+			for (Slot* block : m_blocks)
+				::operator delete(block, std::align_val_t(alignof(Slot)));
+			m_blocks.clear();
+			m_freeList = nullptr;
+		}
+
+		size_t size() const
+		{
+			return m_count;
+		}
+
+		size_t capacity() const
+		{
+			return m_blocks.size() * BlockSize;
+		}
+
+	private:
+		union Slot
+		{
+			Slot* next;
+			alignas(T) unsigned char storage[sizeof(T)];
+		};
+
+		void grow()
+		{
+			Slot* block = static_cast<Slot*>(::operator new(sizeof(Slot) * BlockSize, std::align_val_t(alignof(Slot))));
+			m_blocks.emplace_back(block);
+			//thread new slots so that they are handed out in address order
+			for (size_t i = 0; i < BlockSize - 1; ++i)
+				block[i].next = &block[i + 1];
+			block[BlockSize - 1].next = m_freeList;
+			m_freeList = block;
+		}
+
+		Container::Vector<Slot*> m_blocks;
+		Slot* m_freeList = nullptr;
+		size_t m_count = 0;
+	};
+}
+#endif
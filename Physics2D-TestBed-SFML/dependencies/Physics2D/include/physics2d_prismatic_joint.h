@@ -294,6 +294,14 @@ namespace Physics2D
 			}
 
 
+		}
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
 		}
 		PrismaticJointPrimitive& primitive()
 		{
@@ -42,6 +42,14 @@ namespace Physics2D
 		{
 
 		}
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
+		}
 	private:
 		PulleyJointPrimitive m_primitive;
 	};
@@ -216,6 +216,14 @@ namespace Physics2D
 			bodyB->rotation() -= Vector2::crossProduct(rb, impulse) * ii_b;
 
 		}
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
+		}
 		RevoluteJointPrimitive& primitive()
 		{
 			return m_primitive;
@@ -66,6 +66,14 @@ namespace Physics2D
 		void solvePosition(const real& dt) override
 		{
 
+		}
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
 		}
 		RotationJointPrimitive primitive()const
 		{
@@ -129,6 +137,14 @@ namespace Physics2D
 		void solvePosition(const real& dt) override
 		{
 
+		}
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return nullptr;
 		}
 		OrientationJointPrimitive primitive()const
 		{
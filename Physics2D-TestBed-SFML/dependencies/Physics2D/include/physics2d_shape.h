@@ -43,20 +43,46 @@ namespace Physics2D
 		real rotation = 0;
 		real scale = 1.0f;
 
+		//rotation is written directly everywhere, so the matrix is checked against the angle it was built for
+		//instead of being invalidated on write
+		const Matrix2x2& rotationMatrix() const
+		{
+			if (m_matrixRotation != rotation)
+			{
+				m_matrix.set(rotation);
+				m_matrixRotation = rotation;
+			}
+			return m_matrix;
+		}
+
+		//sets rotation together with a matrix that is already known, e.g. the one cached by the body
+		void setRotation(const real& radian, const Matrix2x2& matrix)
+		{
+			rotation = radian;
+			m_matrix = matrix;
+			m_matrixRotation = radian;
+		}
+
 		Vector2 translatePoint(const Vector2& source) const
 		{
-			return Matrix2x2(rotation).multiply(source) * scale + position;
+			return rotationMatrix().multiply(source) * scale + position;
 		}
 
 		Vector2 inverseTranslatePoint(const Vector2& source) const
 		{
-			return Matrix2x2(-rotation).multiply(source - position) / scale;
+			return inverseRotatePoint(source - position) / scale;
 		}
 
+		//the inverse of a rotation matrix is its transpose
 		Vector2 inverseRotatePoint(const Vector2& point) const
 		{
-			return Matrix2x2(-rotation).multiply(point);
+			const Matrix2x2& matrix = rotationMatrix();
+			return Vector2(matrix.column1.dot(point), matrix.column2.dot(point));
 		}
+
+	private:
+		mutable Matrix2x2 m_matrix;
+		mutable real m_matrixRotation = std::numeric_limits<real>::quiet_NaN();
 	};
 
 	/**
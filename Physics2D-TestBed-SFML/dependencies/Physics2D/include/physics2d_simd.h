@@ -0,0 +1,198 @@
+#ifndef PHYSICS2D_SIMD_H
+#define PHYSICS2D_SIMD_H
+#include "physics2d_math.h"
+#include <bit>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PHYSICS2D_SIMD_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace Physics2D
+{
+	/// <summary>
+	/// Four float lanes, one SSE register when the target has it and a plain array otherwise.
+	/// Loads and stores expect 16 byte aligned data.
+	/// </summary>
+	struct Float4
+	{
+#ifdef PHYSICS2D_SIMD_SSE
+		__m128 value;
+
+		static Float4 load(const float* data)
+		{
+			return {_mm_load_ps(data)};
+		}
+		static Float4 set(float x)
+		{
+			return {_mm_set1_ps(x)};
+		}
+		void store(float* data) const
+		{
+			_mm_store_ps(data, value);
+		}
+#else
+		float value[4];
+
+		static Float4 load(const float* data)
+		{
+			return {{data[0], data[1], data[2], data[3]}};
+		}
+		static Float4 set(float x)
+		{
+			return {{x, x, x, x}};
+		}
+		void store(float* data) const
+		{
+			for (int i = 0; i < 4; ++i)
+				data[i] = value[i];
+		}
+#endif
+	};
+
+#ifdef PHYSICS2D_SIMD_SSE
+	inline Float4 operator+(const Float4& a, const Float4& b)
+	{
+		return {_mm_add_ps(a.value, b.value)};
+	}
+	inline Float4 operator-(const Float4& a, const Float4& b)
+	{
+		return {_mm_sub_ps(a.value, b.value)};
+	}
+	inline Float4 operator*(const Float4& a, const Float4& b)
+	{
+		return {_mm_mul_ps(a.value, b.value)};
+	}
+	inline Float4 operator-(const Float4& a)
+	{
+		return {_mm_sub_ps(_mm_setzero_ps(), a.value)};
+	}
+	inline Float4 min(const Float4& a, const Float4& b)
+	{
+		return {_mm_min_ps(a.value, b.value)};
+	}
+	inline Float4 max(const Float4& a, const Float4& b)
+	{
+		return {_mm_max_ps(a.value, b.value)};
+	}
+	inline Float4 operator/(const Float4& a, const Float4& b)
+	{
+		return {_mm_div_ps(a.value, b.value)};
+	}
+	//comparisons give a mask with every bit of a lane set where they hold, masks are combined bitwise
+	inline Float4 lessThan(const Float4& a, const Float4& b)
+	{
+		return {_mm_cmplt_ps(a.value, b.value)};
+	}
+	inline Float4 lessEqual(const Float4& a, const Float4& b)
+	{
+		return {_mm_cmple_ps(a.value, b.value)};
+	}
+	inline Float4 operator&(const Float4& a, const Float4& b)
+	{
+		return {_mm_and_ps(a.value, b.value)};
+	}
+	inline Float4 operator|(const Float4& a, const Float4& b)
+	{
+		return {_mm_or_ps(a.value, b.value)};
+	}
+	//b without the lanes of mask
+	inline Float4 andNot(const Float4& mask, const Float4& b)
+	{
+		return {_mm_andnot_ps(mask.value, b.value)};
+	}
+	//a where mask is set, b elsewhere
+	inline Float4 select(const Float4& mask, const Float4& a, const Float4& b)
+	{
+		return {_mm_or_ps(_mm_and_ps(mask.value, a.value), _mm_andnot_ps(mask.value, b.value))};
+	}
+	//bit i is set if lane i of the mask is set
+	inline int bits(const Float4& mask)
+	{
+		return _mm_movemask_ps(mask.value);
+	}
+#else
+	inline Float4 operator+(const Float4& a, const Float4& b)
+	{
+		return {{a.value[0] + b.value[0], a.value[1] + b.value[1], a.value[2] + b.value[2], a.value[3] + b.value[3]}};
+	}
+	inline Float4 operator-(const Float4& a, const Float4& b)
+	{
+		return {{a.value[0] - b.value[0], a.value[1] - b.value[1], a.value[2] - b.value[2], a.value[3] - b.value[3]}};
+	}
+	inline Float4 operator*(const Float4& a, const Float4& b)
+	{
+		return {{a.value[0] * b.value[0], a.value[1] * b.value[1], a.value[2] * b.value[2], a.value[3] * b.value[3]}};
+	}
+	inline Float4 operator-(const Float4& a)
+	{
+		return {{-a.value[0], -a.value[1], -a.value[2], -a.value[3]}};
+	}
+	inline Float4 min(const Float4& a, const Float4& b)
+	{
+		return {{std::min(a.value[0], b.value[0]), std::min(a.value[1], b.value[1]),
+			std::min(a.value[2], b.value[2]), std::min(a.value[3], b.value[3])}};
+	}
+	inline Float4 max(const Float4& a, const Float4& b)
+	{
+		return {{std::max(a.value[0], b.value[0]), std::max(a.value[1], b.value[1]),
+			std::max(a.value[2], b.value[2]), std::max(a.value[3], b.value[3])}};
+	}
+	inline Float4 operator/(const Float4& a, const Float4& b)
+	{
+		return {{a.value[0] / b.value[0], a.value[1] / b.value[1], a.value[2] / b.value[2], a.value[3] / b.value[3]}};
+	}
+	//masks use the bit patterns of sse, every bit of a lane set where a comparison holds
+	inline Float4 lessThan(const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<float>(a.value[i] < b.value[i] ? ~uint32_t(0) : uint32_t(0));
+		return result;
+	}
+	inline Float4 lessEqual(const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<float>(a.value[i] <= b.value[i] ? ~uint32_t(0) : uint32_t(0));
+		return result;
+	}
+	inline Float4 operator&(const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<float>(std::bit_cast<uint32_t>(a.value[i]) & std::bit_cast<uint32_t>(b.value[i]));
+		return result;
+	}
+	inline Float4 operator|(const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<float>(std::bit_cast<uint32_t>(a.value[i]) | std::bit_cast<uint32_t>(b.value[i]));
+		return result;
+	}
+	inline Float4 andNot(const Float4& mask, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<float>(~std::bit_cast<uint32_t>(mask.value[i]) & std::bit_cast<uint32_t>(b.value[i]));
+		return result;
+	}
+	inline Float4 select(const Float4& mask, const Float4& a, const Float4& b)
+	{
+		Float4 result;
+		for (int i = 0; i < 4; ++i)
+			result.value[i] = std::bit_cast<uint32_t>(mask.value[i]) != 0 ? a.value[i] : b.value[i];
+		return result;
+	}
+	inline int bits(const Float4& mask)
+	{
+		int result = 0;
+		for (int i = 0; i < 4; ++i)
+			result |= (std::bit_cast<uint32_t>(mask.value[i]) != 0 ? 1 : 0) << i;
+		return result;
+	}
+#endif
+}
+#endif
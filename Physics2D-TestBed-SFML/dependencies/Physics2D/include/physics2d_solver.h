@@ -2,9 +2,62 @@
 #define PHYSICS2D_SOLVER_H
 
 #include "physics2d_joint.h"
+#include "physics2d_joints.h"
+#include "physics2d_weld_joint.h"
+#include "physics2d_contact.h"
 
 namespace Physics2D
 {
-	
+	/// <summary>
+	/// Extended position based dynamics, after Müller et al. "Detailed Rigid Body Simulation with Extended
+	/// Position Based Dynamics". Every sub-step integrates the bodies, projects each contact and joint once on
+	/// the positions, derives the velocities from how far the bodies moved, then applies dynamic friction and
+	/// restitution on the velocities. Contacts keep the normal and anchors of the detection of the step, which
+	/// makes speculative contacts for every pair that can touch within it.
+	/// Compliance is the inverse stiffness, 0 makes a constraint rigid.
+	/// A constraint only writes its own two bodies, so the constraints of a color can be projected in parallel.
+	/// </summary>
+	class PHYSICS2D_API XPBDSolver
+	{
+	public:
+		//pose every body starts the sub-step from and the normal velocity of every contact point before it moves,
+		//the multipliers of the last sub-step are cleared
+		void beginSubStep(ContactMaintainer& maintainer, BodyStore& store, const Vector2& gravity, const real& h);
+		void solvePosition(ContactManifold& contactList, const real& h);
+		void solvePosition(Joint* joint, const real& h);
+		//velocity of the dynamic bodies from their motion over the sub-step
+		void updateVelocities(BodyStore& store, const real& h);
+		void solveVelocity(ContactManifold& contactList, const real& h);
+		void solveVelocity(Joint* joint, const real& h);
+		//joints that have a position based form, the others run their own solvers on every sub-step
+		static bool projectable(Joint* joint);
+
+		int m_subStepCount = 20;
+		real m_contactCompliance = 0.0f;
+		real m_jointCompliance = 0.0f;
+
+	private:
+		struct PointState
+		{
+			real normalLambda = 0;
+			real normalVelocity = 0;
+			//overlapping when the positions were projected, the velocity pass keeps it from closing further
+			bool touching = false;
+		};
+
+		PointState* stateOf(const ContactManifold& contactList);
+
+		//indexed like the contact table, two points per manifold
+		Container::Vector<PointState> m_points;
+		const ContactManifold* m_table = nullptr;
+		Container::Vector<Vector2> m_position;
+		Container::Vector<real> m_rotation;
+		//penetration that is left, so that resting contacts are still found by the next detection
+		real m_slop = 0;
+		//deepest penetration pushed out in one sub-step, ContactMaintainer::m_maxPushVelocity over it
+		real m_maxCorrection = 0;
+		//slower approaches come from gravity alone within the sub-step and do not bounce
+		real m_restitutionThreshold = 0;
+	};
 }
 #endif
@@ -7,9 +7,53 @@
 #include "physics2d_ccd.h"
 #include "physics2d_sap.h"
 #include "physics2d_grid.h"
+#include "physics2d_island.h"
+#include "physics2d_thread_pool.h"
+#include "physics2d_solver.h"
 
 namespace Physics2D
 {
+	/// <summary>
+	/// Timing and counters of one PhysicsSystem::step.
+	/// Durations are in milliseconds. The phases below are measured in the single solve of the whole world,
+	/// the local sub-steps of bullets are part of ccd.
+	/// </summary>
+	struct PHYSICS2D_API StepProfile
+	{
+		double integrateVelocity = 0.0;
+		double broadphase = 0.0;
+		double narrowphase = 0.0;
+		double buildIslands = 0.0;
+		double prepareVelocity = 0.0;
+		double solveVelocity = 0.0;
+		double integratePosition = 0.0;
+		double solvePosition = 0.0;
+		double updateTree = 0.0;
+		//toi search of bullets and the local sub-steps that resolve their impacts
+		double ccd = 0.0;
+		double total = 0.0;
+
+		size_t pairCount = 0;
+		size_t collidingCount = 0;
+		size_t contactPointCount = 0;
+		//toi events resolved in a local sub-step
+		size_t ccdSolveCount = 0;
+		//gjk distance queries spent finding times of impact
+		size_t toiQueryCount = 0;
+		size_t islandCount = 0;
+		size_t awakeIslandCount = 0;
+		size_t colorCount = 0;
+		//pairs that went through gjk and the gjk iterations they took, a warm started hit counts as one
+		size_t gjkCount = 0;
+		size_t gjkIterationCount = 0;
+		//pairs whose bodies did not move, their contacts of the last step were prepared again without detection
+		size_t reusedCount = 0;
+		//pairs the batched gjk proved apart before contact generation
+		size_t rejectedCount = 0;
+		//pairs that were apart but close enough to touch within the step, they are not part of collidingCount
+		size_t speculativeCount = 0;
+	};
+
 	class PHYSICS2D_API PhysicsSystem
 	{
 	public:
@@ -18,6 +62,7 @@ namespace Physics2D
 		ContactMaintainer& maintainer();
 		Tree& tree();
 		UniformGrid& grid();
+		IslandBuilder& islandBuilder();
 		int& positionIteration();
 		int& velocityIteration();
 		bool& sliceDeltaTime();
@@ -25,13 +70,61 @@ namespace Physics2D
 		bool& solveJointPosition();
 		bool& solveContactVelocity();
 		bool& solveContactPosition();
+		//solve awake islands and run the narrowphase on the worker pool
+		bool& parallelSolve();
+		ThreadPool& threadPool();
+		//islands with at least this many contacts and joints are graph-colored and solved by all threads together
+		size_t& coloringThreshold();
+		//broadphase pairs are tested four at a time with a batched gjk first, only the pairs it cannot prove apart
+		//get their contacts generated, see Narrowphase::gjkSeparated
+		bool& batchedRejection();
+		//circle, capsule and polygon pairs get their contacts analytically, see Detector::detect
+		bool& analyticContacts();
+		//pairs left to gjk and epa run a kernel compiled for their shape types, see Detector::detect
+		bool& typedKernels();
+		//leaves of the tree are swept by the velocity of their body, and pairs that are apart by less than they close
+		//in one step get speculative contacts that only remove the velocity left after the gap is closed.
+		//catches most fast bodies at the cost of the contacts, bullets remain for the extreme cases
+		bool& speculativeContacts();
+		//detection runs once per step, then the step is cut into subStepCount sub-steps that each integrate the
+		//velocities, solve the contacts once as soft springs, integrate the positions and relax the contacts
+		//without the spring. Replaces the velocity iterations and the position solver
+		bool& softStep();
+		int& subStepCount();
+		//the contacts and joints are solved by the xpbd solver instead, with its own sub-steps, see XPBDSolver.
+		//takes precedence over the soft step and makes speculative contacts whether they are turned on or not
+		bool& xpbd();
+		XPBDSolver& xpbdSolver();
+
+		const StepProfile& profile() const;
+		//last Constant::ProfileHistoryCount profiles, oldest first
+		Container::Vector<StepProfile> profileHistory() const;
 
 	private:
-		void updateTree();
+		void updateTree(const real& dt);
 		void updateGrid();
 		void solve(const real& dt);
-		bool solveCCD(const real& dt);
+		//fast bullets and the pose every body starts the step from, taken before the world is solved
+		void collectBullets();
+		//times of impact of the collected bullets in a queue, earliest first. Each one moves the bullet and the body
+		//it hits back to that time and solves them alone for the rest of the step, the other bodies are not touched
+		void solveCCD(const real& dt);
 		void solveOnce(const real& dt);
+		void recordProfile();
+		void prepareIsland(Island& island, const real& vdt);
+		void solveIslandVelocity(Island& island, const real& vdt, const real& dt);
+		void solveIslandPosition(Island& island, const real& pdt);
+		void solveIslandRestitution(Island& island, const real& dt);
+		//joints are prepared for every sub-step, which warm starts them like the contacts
+		void warmStartIsland(Island& island, const real& h);
+		//with the bias joints solve their velocities and contacts push apart, without it joints correct their
+		//positions and contacts only remove the velocity the push left
+		void solveIslandSoft(Island& island, const real& h, bool useBias);
+		//positions are projected first, the velocity pass follows once the velocities are derived from them
+		void solveIslandXPBD(Island& island, const real& h, bool position);
+		void scheduleIslands();
+		void detectPairs(const Container::Vector<std::pair<Body*, Body*>>& pairs,
+		                 const Container::Vector<CollisionCache*>& caches, const real& dt, bool parallel);
 		int m_positionIteration = 1;
 		int m_velocityIteration = 1;
 		bool m_sliceDeltaTime = false;
@@ -39,10 +132,40 @@ namespace Physics2D
 		bool m_solveJointPosition = true;
 		bool m_solveContactVelocity = true;
 		bool m_solveContactPosition = true;
+		bool m_parallelSolve = false;
+		size_t m_coloringThreshold = 128;
+		bool m_batchedRejection = true;
+		bool m_analyticContacts = true;
+		bool m_typedKernels = true;
+		bool m_speculativeContacts = false;
+		bool m_softStep = false;
+		int m_subStepCount = 4;
+		bool m_xpbd = false;
+		XPBDSolver m_xpbdSolver;
 		PhysicsWorld m_world;
 		ContactMaintainer m_maintainer;
 		Tree m_tree;
 		UniformGrid m_grid;
+		IslandBuilder m_islandBuilder;
+		ThreadPool m_threadPool;
+		//pool the colors of the current step run on, nullptr to run them on the calling thread
+		ThreadPool* m_colorPool = nullptr;
+		//awake islands of every worker batch, balanced by solver cost
+		Container::Vector<Container::Vector<Island*>> m_islandBatches;
+		//colliding results of every narrowphase chunk, merged in chunk order so that the contact table is filled as on one thread
+		Container::Vector<Container::Vector<Collision>> m_collisionBuffers;
+		//speculative results of every chunk, merged after the colliding ones
+		Container::Vector<Container::Vector<Collision>> m_speculativeBuffers;
+		//bullets of the current step and the pose of every body in the store before it was solved
+		Container::Vector<Body*> m_bullets;
+		Container::Vector<Vector2> m_stepPosition;
+		Container::Vector<real> m_stepRotation;
+		//contacts of one toi sub-step, kept apart so that they never warm start the next step
+		ContactMaintainer m_toiMaintainer;
+
+		StepProfile m_profile;
+		Container::Vector<StepProfile> m_profileHistory;
+		size_t m_profileHistoryHead = 0;
 	};
 }
 #endif
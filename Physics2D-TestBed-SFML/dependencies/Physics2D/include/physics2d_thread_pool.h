@@ -0,0 +1,56 @@
+#ifndef PHYSICS2D_THREAD_POOL_H
+#define PHYSICS2D_THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "physics2d_common.h"
+
+namespace Physics2D
+{
+	/// <summary>
+	/// Persistent worker threads for fork-join work inside one step.
+	/// The calling thread always takes part, so a pool of n threads starts n - 1 workers.
+	/// Workers are started lazily on the first run and sleep on a condition variable between runs.
+	/// </summary>
+	class PHYSICS2D_API ThreadPool
+	{
+	public:
+		ThreadPool() = default;
+		~ThreadPool();
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		//total number of threads including the caller, 0 means one per hardware thread
+		void setThreadCount(size_t count);
+		size_t threadCount() const;
+
+		//run task(i) for every i in [0, count) and return once all of them finished
+		void run(size_t count, const std::function<void(size_t)>& task);
+
+		//split [0, count) into ranges of at least grain elements and run body(begin, end) on them
+		void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+	private:
+		void start();
+		void stop();
+		void work(uint64_t generation);
+		void drain();
+
+		size_t m_threadCount = 0;
+		Container::Vector<std::thread> m_workers;
+
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_finished;
+		uint64_t m_generation = 0;
+		size_t m_busy = 0;
+		bool m_stop = false;
+
+		const std::function<void(size_t)>* m_task = nullptr;
+		size_t m_taskCount = 0;
+		std::atomic<size_t> m_next = 0;
+	};
+}
+#endif
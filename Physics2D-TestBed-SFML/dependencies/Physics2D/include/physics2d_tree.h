@@ -2,12 +2,19 @@
 #define PHYSICS2D_BROADPHASE_DBVT_H
 
 #include "physics2d_aabb.h"
+#include "physics2d_body.h"
+#include "physics2d_narrowphase.h"
 
 namespace Physics2D
 {
 	/// <summary>
 	/// Dynamic Bounding Volume Tree
 	///	This is implemented by dynamic array-arranged.
+	/// Overlapping fat AABB pairs are cached between steps. Only bodies inserted or reinserted since the last
+	/// updatePairs are queried again, so the cost follows the number of moving bodies instead of all bodies.
+	/// Every body indexes its cached pairs, and the reported pairs are kept from one updatePairs to the next. Only
+	/// the pairs of bodies that are awake or were moved since then are tested again.
+	/// Every cached pair also keeps the narrowphase state of the last step, see CollisionCache.
 	/// </summary>
 	class PHYSICS2D_API Tree
 	{
@@ -31,13 +38,27 @@ namespace Physics2D
 		Container::Vector<Body*> query(const AABB& aabb);
 		Container::Vector<Body*> raycast(const Vector2& point, const Vector2& direction);
 		Container::Vector<std::pair<Body*, Body*>> generate();
+		//same pairs as generate, taken from the pair cache. Valid until the next call.
+		//with a sweep time the boxes of the bodies also cover where their velocity takes them within it
+		const Container::Vector<std::pair<Body*, Body*>>& updatePairs(const real& sweep = 0);
+		//collision cache of every pair of the last updatePairs, in the same order
+		const Container::Vector<CollisionCache*>& pairCaches() const;
+		//fat AABB pairs that started or stopped overlapping in the last updatePairs
+		const Container::Vector<std::pair<Body*, Body*>>& beginPairs() const;
+		const Container::Vector<std::pair<Body*, Body*>>& endPairs() const;
+		size_t cachedPairCount() const;
 		void insert(Body* body);
 		void remove(Body* body);
 		void clearAll();
 		void update(Body* body);
+		//the leaf also covers the shape moved by displacement, so that pairs the body reaches within the next step are
+		//found before the shapes touch
+		void update(Body* body, const Vector2& displacement);
 		const Container::Vector<Node>& tree();
 		int rootIndex()const;
 	private:
+		//fat is the box stored in the leaf
+		void insert(Body* body, const AABB& fat);
 		void queryNodes(int nodeIndex, const AABB& aabb, Container::Vector<Body*>& result);
 		void traverseLowestCost(int nodeIndex, int boxIndex, real& cost, int& finalIndex);
 		void raycast(Container::Vector<Body*>& result, int nodeIndex, const Vector2& p, const Vector2& d);
@@ -64,6 +85,43 @@ namespace Physics2D
 		Container::Vector<Node> m_tree;
 		Container::Vector<int> m_emptyList;
 		Container::Map<Body*, int> m_bodyTable;
+
+		struct CachedPair;
+		struct Proxy
+		{
+			Body* body = nullptr;
+			//tight box of the last update, and the box the pairs of the body were last tested with
+			AABB tight;
+			AABB swept;
+			Container::Vector<CachedPair*> pairs;
+		};
+		struct CachedPair
+		{
+			std::pair<Body*, Body*> bodies;
+			Proxy* proxies[2] = {};
+			CollisionCache cache;
+			//index in m_pairs while the pair is reported
+			size_t slot = SIZE_MAX;
+		};
+
+		void erase(CachedPair* pair);
+		void report(CachedPair* pair, bool overlap);
+
+		//bodies whose leaf changed since the last updatePairs
+		Container::Vector<Body*> m_moveBuffer;
+		//bodies whose pairs are tested again in the next updatePairs
+		Container::Vector<Proxy*> m_touchBuffer;
+		Container::Map<Body*, Proxy> m_proxies;
+		//fat AABB pairs by pair id, the body with the lower id first
+		Container::Map<Body::BodyPair::BodyPairID, CachedPair> m_pairTable;
+		//reported pairs and their caches, owners is the cached pair of every slot
+		Container::Vector<std::pair<Body*, Body*>> m_pairs;
+		Container::Vector<CollisionCache*> m_pairCaches;
+		Container::Vector<CachedPair*> m_pairOwners;
+		Container::Vector<std::pair<Body*, Body*>> m_beginPairs;
+		Container::Vector<std::pair<Body*, Body*>> m_endPairs;
+		//sweep time of the last updatePairs, every pair is tested again when it changes
+		real m_sweep = 0;
 	};
 
 	
@@ -280,6 +280,14 @@ namespace Physics2D
 
 		}
 
+		Body* bodyA() const override
+		{
+			return m_primitive.bodyA;
+		}
+		Body* bodyB() const override
+		{
+			return m_primitive.bodyB;
+		}
 		WeldJointPrimitive primitive()const
 		{
 			return m_primitive;
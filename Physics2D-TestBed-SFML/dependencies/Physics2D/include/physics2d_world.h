@@ -8,6 +8,7 @@
 #include "physics2d_random.h"
 #include "physics2d_contact.h"
 #include "physics2d_weld_joint.h"
+#include "physics2d_pool.h"
 
 namespace Physics2D
 {
@@ -29,6 +30,14 @@ namespace Physics2D
 		void solveVelocityConstraint(real dt);
 		void stepPosition(const real& dt);
 		void solvePositionConstraint(real dt);
+		//integration alone, without waking bodies, clearing forces or counting down sleep.
+		//sub-steps of a step use these in between stepVelocity and finishStep
+		void integrateVelocity(const real& dt);
+		void integratePosition(const real& dt);
+		//stepPosition split up, sub-stepping saves the poses before its first sub-step and finishes after the last one,
+		//so the sleep energy measures the movement of the whole step
+		void saveLastPosition();
+		void finishStep();
 
 
 		Vector2 gravity() const;
@@ -78,9 +87,11 @@ namespace Physics2D
 		real bias() const;
 		void setBias(const real& bias);
 
-		Container::Vector<std::unique_ptr<Body>>& bodyList();
+		Container::Vector<PoolPtr<Body>>& bodyList();
 
-		Container::Vector<std::unique_ptr<Joint>>& jointList();
+		Container::Vector<PoolPtr<Joint>>& jointList();
+
+		BodyStore& bodyStore();
 
 		bool& enableSleep();
 
@@ -97,8 +108,22 @@ namespace Physics2D
 		bool m_enableGravity = true;
 		bool m_enableDamping = true;
 		bool m_enableSleep = false;
-		Container::Vector<std::unique_ptr<Body>> m_bodyList;
-		Container::Vector<std::unique_ptr<Joint>> m_jointList;
+		//pools are declared before the lists so that they outlive every object handed out
+		ObjectPool<Body> m_bodyPool;
+		ObjectPool<PrismaticJoint, 32> m_prismaticJointPool;
+		ObjectPool<RotationJoint, 32> m_rotationJointPool;
+		ObjectPool<PointJoint, 32> m_pointJointPool;
+		ObjectPool<DistanceJoint, 32> m_distanceJointPool;
+		ObjectPool<PulleyJoint, 32> m_pulleyJointPool;
+		ObjectPool<RevoluteJoint, 32> m_revoluteJointPool;
+		ObjectPool<MotorJoint, 32> m_motorJointPool;
+		ObjectPool<WeldJoint, 32> m_weldJointPool;
+		ObjectPool<OrientationJoint, 32> m_orientationJointPool;
+		ObjectPool<PathJoint, 32> m_pathJointPool;
+
+		BodyStore m_bodyStore;
+		Container::Vector<PoolPtr<Body>> m_bodyList;
+		Container::Vector<PoolPtr<Joint>> m_jointList;
 	};
 
 	class PHYSICS2D_API DiscreteWorld
@@ -128,9 +128,10 @@ namespace Physics2D
 		{
 			const Polygon* polygon = static_cast<Polygon*>(shape.shape);
 			real max_x = Constant::NegativeMin, max_y = Constant::NegativeMin, min_x = Constant::Max, min_y = Constant::Max;
+			const Matrix2x2& rotation = shape.transform.rotationMatrix();
 			for (const Vector2& v : polygon->vertices())
 			{
-				const Vector2 vertex = Matrix2x2(shape.transform.rotation).multiply(v);
+				const Vector2 vertex = rotation.multiply(v);
 				if (max_x < vertex.x)
 					max_x = vertex.x;
 
@@ -157,20 +158,20 @@ namespace Physics2D
 			Vector2 bottom_dir{ 0, -1 };
 			Vector2 right_dir{ 1, 0 };
 
-			top_dir = Matrix2x2(-shape.transform.rotation).multiply(top_dir);
-			left_dir = Matrix2x2(-shape.transform.rotation).multiply(left_dir);
-			bottom_dir = Matrix2x2(-shape.transform.rotation).multiply(bottom_dir);
-			right_dir = Matrix2x2(-shape.transform.rotation).multiply(right_dir);
+			top_dir = shape.transform.inverseRotatePoint(top_dir);
+			left_dir = shape.transform.inverseRotatePoint(left_dir);
+			bottom_dir = shape.transform.inverseRotatePoint(bottom_dir);
+			right_dir = shape.transform.inverseRotatePoint(right_dir);
 
 			Vector2 top = GeometryAlgorithm2D::calculateEllipseProjectionPoint(ellipse->A(), ellipse->B(), top_dir);
 			Vector2 left = GeometryAlgorithm2D::calculateEllipseProjectionPoint(ellipse->A(), ellipse->B(), left_dir);
 			Vector2 bottom = GeometryAlgorithm2D::calculateEllipseProjectionPoint(ellipse->A(), ellipse->B(), bottom_dir);
 			Vector2 right = GeometryAlgorithm2D::calculateEllipseProjectionPoint(ellipse->A(), ellipse->B(), right_dir);
 
-			top = Matrix2x2(shape.transform.rotation).multiply(top);
-			left = Matrix2x2(shape.transform.rotation).multiply(left);
-			bottom = Matrix2x2(shape.transform.rotation).multiply(bottom);
-			right = Matrix2x2(shape.transform.rotation).multiply(right);
+			top = shape.transform.rotationMatrix().multiply(top);
+			left = shape.transform.rotationMatrix().multiply(left);
+			bottom = shape.transform.rotationMatrix().multiply(bottom);
+			right = shape.transform.rotationMatrix().multiply(right);
 
 			aabb.height = std::fabs(top.y - bottom.y);
 			aabb.width = std::fabs(right.x - left.x);
@@ -214,11 +215,7 @@ namespace Physics2D
 		assert(body != nullptr);
 		assert(body->shape() != nullptr);
 		
-		ShapePrimitive primitive;
-		primitive.shape = body->shape();
-		primitive.transform.rotation = body->rotation();
-		primitive.transform.position = body->position();
-		return fromShape(primitive, factor);
+		return body->aabb(factor);
 	}
 
 	AABB AABB::fromBox(const Vector2& topLeft, const Vector2& bottomRight)
@@ -2,252 +2,177 @@
 
 namespace Physics2D
 {
-	std::tuple<CCD::BroadphaseTrajectory, AABB> CCD::buildTrajectoryAABB(Body* body, const Vector2& target, const real& dt)
+	namespace
 	{
-		assert(body != nullptr);
-		Container::Vector<AABBShot> trajectory;
-		AABB result;
-		AABB startBox = AABB::fromBody(body);
-		Body::PhysicsAttribute start = body->physicsAttribute();
-		body->stepPosition(dt);
-		
-		Body::PhysicsAttribute end = body->physicsAttribute();
-		AABB endBox = AABB::fromBody(body);
-
-		if(startBox == endBox && start.velocity.lengthSquare() < Constant::MaxVelocity && std::fabs(start.angularVelocity) < Constant::MaxAngularVelocity)
-		{
-			trajectory.emplace_back(AABBShot( startBox, body->physicsAttribute(), 0));
-			trajectory.emplace_back(AABBShot( endBox, body->physicsAttribute(), dt ));
-			return std::make_tuple(trajectory, result);
-		}
-		
-
-		result.unite(startBox).unite(endBox);
-		
-		body->setPhysicsAttribute(start);
-		
-		real slice = 40;
-		real step = dt / slice;
-		for(real i = step;i <= dt; i += step)
+		template <typename Potentials>
+		std::optional<Container::Vector<CCD::CCDPair>> queryPotentials(const Potentials& potentials, Body* body,
+		                                                               const CCD::Sweep& sweep, const real& dt,
+		                                                               size_t* queries)
 		{
-			body->stepPosition(step);
-			AABB aabb = AABB::fromBody(body);
-			trajectory.emplace_back(AABBShot{aabb, body->physicsAttribute(), i});
-			result.unite(aabb);
+			Container::Vector<CCD::CCDPair> queryList;
+			for (auto& elem : potentials)
+			{
+				//skip detecting itself
+				if (elem == body)
+					continue;
+
+				if (auto toi = CCD::timeOfImpact(CCD::Sweep::fromBody(elem), sweep, dt, queries); toi.has_value())
+					queryList.emplace_back(CCD::CCDPair(toi.value(), elem));
+			}
+			return !queryList.empty() ? std::optional(queryList)
+			                          : std::nullopt;
 		}
-		body->setPhysicsAttribute(start);
-		return std::make_tuple(trajectory, result);
 	}
-	std::tuple<CCD::BroadphaseTrajectory, AABB> CCD::buildTrajectoryAABB(Body* body, const real& dt)
+
+	CCD::Sweep CCD::Sweep::fromBody(Body* body)
 	{
 		assert(body != nullptr);
-		Container::Vector<AABBShot> trajectory;
-		AABB result;
-		AABB startBox = AABB::fromBody(body);
-		Body::PhysicsAttribute start = body->physicsAttribute();
-		body->stepPosition(dt);
-
-		Body::PhysicsAttribute end = body->physicsAttribute();
-		AABB endBox = AABB::fromBody(body);
-
-		if (startBox == endBox && start.velocity.lengthSquare() < Constant::MaxVelocity && std::fabs(start.angularVelocity) < Constant::MaxAngularVelocity)
+		Sweep sweep;
+		sweep.shape = body->shape();
+		sweep.position = body->position();
+		sweep.velocity = body->velocity();
+		sweep.rotation = body->rotation();
+		sweep.angularVelocity = body->angularVelocity();
+
+		switch (sweep.shape->type())
 		{
-			trajectory.emplace_back(AABBShot(startBox, body->physicsAttribute(), 0));
-			trajectory.emplace_back(AABBShot(endBox, body->physicsAttribute(), dt));
-			return std::make_tuple(trajectory, result);
-		}
-
-
-		result.unite(startBox).unite(endBox);
-
-		body->setPhysicsAttribute(start);
-
-		real slice = 40;
-		real step = dt / slice;
-		for (real i = dt / slice; i <= dt;)
+		case ShapeType::Circle:
+			//turning a circle about its center does not move it
+			break;
+		case ShapeType::Polygon:
+			for (const Vector2& vertex : static_cast<const Polygon*>(sweep.shape)->vertices())
+				sweep.radius = Math::max(sweep.radius, vertex.length());
+			break;
+		default:
 		{
-			body->stepPosition(step);
-			AABB aabb = AABB::fromBody(body);
-			trajectory.emplace_back(AABBShot{ aabb, body->physicsAttribute(), i });
-			result.unite(aabb);
-			i += step;
+			//the unrotated box holds the shape, so its furthest corner bounds every point of it
+			ShapePrimitive local;
+			local.shape = sweep.shape;
+			const AABB box = AABB::fromShape(local);
+			for (const Vector2& corner : {box.topLeft(), box.topRight(), box.bottomLeft(), box.bottomRight()})
+				sweep.radius = Math::max(sweep.radius, corner.length());
+			break;
 		}
-		body->setPhysicsAttribute(start);
-		return std::make_tuple(trajectory, result);
+		}
+		return sweep;
 	}
-	std::optional<CCD::IndexSection> CCD::findBroadphaseRoot(Body* staticBody, const BroadphaseTrajectory& staticTrajectory, Body* dynamicBody, const BroadphaseTrajectory& dynamicTrajectory, const real& dt)
-	{
-		assert(staticBody != nullptr && dynamicBody != nullptr);
 
+	ShapePrimitive CCD::Sweep::at(const real& t) const
+	{
+		ShapePrimitive primitive;
+		primitive.shape = shape;
+		primitive.transform.position = position + velocity * t;
+		primitive.transform.rotation = rotation + angularVelocity * t;
+		return primitive;
+	}
 
-		AABB traj1 = AABB::unite(staticTrajectory[0].aabb, staticTrajectory.back().aabb);
-		AABB traj2 = AABB::unite(dynamicTrajectory[0].aabb, dynamicTrajectory.back().aabb);
-		if (!traj1.collide(traj2))
-			return std::nullopt;
+	AABB CCD::Sweep::aabb(const real& dt) const
+	{
+		if (angularVelocity == 0 || radius == 0)
+			return AABB::unite(AABB::fromShape(at(0)), AABB::fromShape(at(dt)));
+
+		//a spinning shape stays inside the circle of its radius
+		const Vector2 extent(radius, -radius);
+		const Vector2 end = position + velocity * dt;
+		return AABB::unite(AABB::fromBox(position - extent, position + extent),
+		                   AABB::fromBox(end - extent, end + extent));
+	}
 
-		IndexSection result;
-		size_t length = dynamicTrajectory.size();
-		bool forwardFound = false;
-		bool backwardFound = false;
-		for (size_t i = 0, j = length - 1; i < length - 1; i++, j--)
+	std::optional<real> CCD::timeOfImpact(const Sweep& sweepA, const Sweep& sweepB, const real& dt, size_t* queries)
+	{
+		assert(sweepA.shape != nullptr && sweepB.shape != nullptr);
+
+		//no point of either shape moves toward the other faster than the relative velocity along the normal
+		//plus the speed rotation gives to the furthest point
+		const Vector2 relativeVelocity = sweepB.velocity - sweepA.velocity;
+		const real angularBound = Math::abs(sweepA.angularVelocity) * sweepA.radius +
+			Math::abs(sweepB.angularVelocity) * sweepB.radius;
+		const real target = Constant::CCDTolerance * 0.5f;
+
+		real t = 0;
+		Vector2 normal;
+		for (unsigned int iteration = 0; iteration < Constant::CCDMaxIterations; ++iteration)
 		{
-			AABB tempForward = AABB::unite(dynamicTrajectory[i].aabb, dynamicTrajectory[i + 1].aabb);
-			AABB tempBackward = AABB::unite(dynamicTrajectory[j].aabb, dynamicTrajectory[j - 1].aabb);
-			if (tempForward.collide(traj1) && !forwardFound)
-			{
-				result.forward = i;
-				forwardFound = true;
-			}
-			if (tempBackward.collide(traj1) && !backwardFound)
+			const ShapePrimitive shapeA = sweepA.at(t);
+			const ShapePrimitive shapeB = sweepB.at(t);
+
+			//overlapping at the start is left to the discrete contacts, unless the step still drives the shapes
+			//into each other. then the impact is right away
+			if (iteration == 0 && Detector::collide(shapeA, shapeB))
 			{
-				result.backward = j;
-				backwardFound = true;
+				const Collision collision = Detector::detect(shapeA, shapeB);
+				if (collision.isColliding && Vector2::dotProduct(relativeVelocity, collision.normal) > 0)
+					return std::optional(real(0));
+				return std::nullopt;
 			}
-			if (forwardFound && backwardFound)
-				break;
-		}
-		return result.forward == -1 ? std::nullopt :
-			std::optional(result);
 
-		
-	}
-	std::optional<real> CCD::findNarrowphaseRoot(Body* staticBody, const BroadphaseTrajectory& staticTrajectory, Body* dynamicBody, const BroadphaseTrajectory& dynamicTrajectory, const IndexSection& index, const real& dt)
-	{
-		assert(staticBody != nullptr && dynamicBody != nullptr);
+			const CollisionInfo info = Narrowphase::gjkDistance(shapeA, shapeB);
+			if (queries != nullptr)
+				++*queries;
 
-		if (dynamicTrajectory.size() < 2)
-			return std::nullopt;
-		
-		Body::PhysicsAttribute staticOrigin = staticBody->physicsAttribute();
-		Body::PhysicsAttribute dynamicOrigin = dynamicBody->physicsAttribute();
-
-		real startTimestep = 0;
-		real endTimestep = 0;
-
-		dynamicBody->setPhysicsAttribute(dynamicTrajectory[index.forward].attribute);
-		startTimestep = dynamicTrajectory[index.forward].time;
-		endTimestep = dynamicTrajectory[index.backward].time;
-
-		//slice maybe 25~70. It depends on how thin the sticks you set
-		const real slice = 30.0;
-		real step = (endTimestep - startTimestep) / slice;
-		real forwardSteps = 0;
-		Body::PhysicsAttribute lastAttribute;
-		//forwarding
-		bool isFound = false;
-		while (startTimestep + forwardSteps <= endTimestep)
-		{
-			lastAttribute = dynamicBody->physicsAttribute();
-			dynamicBody->stepPosition(step);
-			forwardSteps += step;
-			if (const bool result = Detector::collide(staticBody, dynamicBody); result)
+			//gjk distance of round shapes is measured to an inscribed polytope and may come out too long,
+			//the gap between the support points along its normal never does.
+			//shapes that touch too little to make a contact keep the last normal
+			real distance = 0;
+			if (const Vector2 gap = info.pair.pointB - info.pair.pointA; !gap.fuzzyEqual({0, 0}))
 			{
-				forwardSteps -= step;
-				dynamicBody->setPhysicsAttribute(lastAttribute);
-				isFound = true;
-				break;
+				normal = gap.normal();
+				distance = Vector2::dotProduct(Narrowphase::findFurthestPoint(shapeB, normal.negative()).first, normal) -
+					Vector2::dotProduct(Narrowphase::findFurthestPoint(shapeA, normal).first, normal);
 			}
-		}
+			else if (iteration == 0)
+				return std::nullopt;
 
-		if (!isFound)
-		{
-			staticBody->setPhysicsAttribute(staticOrigin);
-			dynamicBody->setPhysicsAttribute(dynamicOrigin);
-			return std::nullopt;
-		}
+			const real bound = angularBound - Vector2::dotProduct(relativeVelocity, normal);
+			if (bound <= 0)
+				return std::nullopt;
 
-		//retracing
-		step /= 2.0f;
-		const real epsilon = 0.01f;
-		unsigned int counter = 0;
-		while (startTimestep + forwardSteps <= endTimestep)
-		{
-			lastAttribute = dynamicBody->physicsAttribute();
-			dynamicBody->stepPosition(step);
-			forwardSteps += step;
-			if (const auto result = Detector::detect(staticBody, dynamicBody); result.isColliding)
+			if (distance >= Constant::CCDTolerance)
 			{
-				if (std::fabs(result.penetration) < epsilon || counter >= Constant::CCDMaxIterations)
-				{
-					staticBody->setPhysicsAttribute(staticOrigin);
-					dynamicBody->setPhysicsAttribute(dynamicOrigin);
-					return std::optional(startTimestep + forwardSteps);
-				}
-
-				forwardSteps -= step;
-				dynamicBody->setPhysicsAttribute(lastAttribute);
-				step /= 2.0;
+				t += (distance - target) / bound;
+				if (t >= dt)
+					return std::nullopt;
+				continue;
 			}
-			counter++;
-		}
 
-
-		return std::nullopt;
+			//contacts are only made for overlapping shapes, so the pair is handed over at most
+			//Constant::CCDPenetration past touching. points that graze past each other may not make a contact
+			//there yet and the advancement goes on
+			t += (Math::max(distance, real(0)) + Constant::CCDPenetration) / bound;
+			if (t >= dt)
+				return std::nullopt;
+			if (Detector::detect(sweepA.at(t), sweepB.at(t)).isColliding)
+				break;
+		}
+		//also reached when the queries ran out short of a contact, solveCCD schedules the pair again from there
+		return std::optional(t);
 	}
 
-    std::optional<Container::Vector<CCD::CCDPair>> CCD::query(Tree& tree, Body* body, const real& dt)
-    {
-        Container::Vector<CCDPair> queryList;
-        assert(body != nullptr);
-        auto [trajectoryCCD, aabbCCD] = buildTrajectoryAABB(body, dt);
-        auto potentials = tree.query(aabbCCD);
-
-        for(auto& elem: potentials)
-        {
-            //skip detecting itself
-            if(elem == body)
-                continue;
-
-            auto [trajectoryElement, aabbElement] = buildTrajectoryAABB(elem, dt);
-            auto [newCCDTrajectory, newAABB] = buildTrajectoryAABB(body, elem->position(), dt);
-            auto result = findBroadphaseRoot(elem, trajectoryElement, body, newCCDTrajectory, dt);
-            if(result.has_value())
-            {
-                auto toi = findNarrowphaseRoot(elem, trajectoryElement, body, newCCDTrajectory, result.value(), dt);
-                if (toi.has_value())
-                    queryList.emplace_back(CCDPair(toi.value(), elem));
-            }
-        }
-        return !queryList.empty() ? std::optional(queryList)
-                                  : std::nullopt;
-    }
-
-    std::optional<Container::Vector<CCD::CCDPair>> CCD::query(UniformGrid& grid, Body* body, const real& dt)
-    {
-		Container::Vector<CCDPair> queryList;
+	std::optional<Container::Vector<CCD::CCDPair>> CCD::query(Tree& tree, Body* body, const real& dt, size_t* queries)
+	{
 		assert(body != nullptr);
-		auto [trajectoryCCD, aabbCCD] = buildTrajectoryAABB(body, dt);
-		auto potentials = grid.query(aabbCCD);
-
-		for (auto& elem : potentials)
-		{
-			//skip detecting itself
-			if (elem == body)
-				continue;
+		const Sweep sweep = Sweep::fromBody(body);
+		return queryPotentials(tree.query(sweep.aabb(dt)), body, sweep, dt, queries);
+	}
 
-			auto [trajectoryElement, aabbElement] = buildTrajectoryAABB(elem, dt);
-			auto [newCCDTrajectory, newAABB] = buildTrajectoryAABB(body, elem->position(), dt);
-			auto result = findBroadphaseRoot(elem, trajectoryElement, body, newCCDTrajectory, dt);
-			if (result.has_value())
-			{
-				auto toi = findNarrowphaseRoot(elem, trajectoryElement, body, newCCDTrajectory, result.value(), dt);
-				if (toi.has_value())
-					queryList.emplace_back(CCDPair(toi.value(), elem));
-			}
-		}
-		return !queryList.empty() ? std::optional(queryList)
-			: std::nullopt;
-    }
+	std::optional<Container::Vector<CCD::CCDPair>> CCD::query(UniformGrid& grid, Body* body, const real& dt,
+	                                                          size_t* queries)
+	{
+		assert(body != nullptr);
+		const Sweep sweep = Sweep::fromBody(body);
+		return queryPotentials(grid.query(sweep.aabb(dt)), body, sweep, dt, queries);
+	}
 
-    std::optional<real> CCD::earliestTOI(const Container::Vector<CCDPair> &pairs, const real &epsilon) {
-        if(pairs.empty())
-            return std::nullopt;
+	std::optional<real> CCD::earliestTOI(const Container::Vector<CCDPair>& pairs, const real& epsilon)
+	{
+		if (pairs.empty())
+			return std::nullopt;
 
-        real minToi = Constant::Max;
-		for (const auto& elem : pairs) 
-			if (elem.toi < minToi) 
+		real minToi = Constant::Max;
+		for (const auto& elem : pairs)
+			if (elem.toi < minToi)
 				minToi = elem.toi;
 
-        return minToi;
-    }
+		return minToi;
+	}
 }
@@ -1,6 +1,429 @@
 #include "physics2d_detector.h"
 namespace Physics2D
 {
+	namespace
+	{
+		//polygons with more vertices than this take the gjk path
+		constexpr size_t MaxHullVertices = 16;
+		//a tenth of the default allowed penetration, keeps the reference face stable and
+		//vertex to vertex normals safe to normalize
+		constexpr real LinearTolerance = 0.0005f;
+		//speculative pairs are moved this far into each other to generate their contacts. gjk closest points of
+		//nearly touching shapes are off by more than the gap itself, so it is well above LinearTolerance
+		constexpr real SpeculativeOverlap = 0.01f;
+
+		//convex core in world space, the shape is the core grown by radius.
+		//normals[i] is the outward normal of the edge from vertices[i] to vertices[i + 1]
+		struct Hull
+		{
+			Vector2 vertices[MaxHullVertices];
+			Vector2 normals[MaxHullVertices];
+			size_t count = 0;
+			real radius = 0;
+		};
+
+		bool makeHull(const ShapePrimitive& primitive, Hull& hull)
+		{
+			const Transform& transform = primitive.transform;
+			const Matrix2x2& rotation = transform.rotationMatrix();
+			if (primitive.shape->type() == ShapeType::Polygon)
+			{
+				auto polygon = static_cast<const Polygon*>(primitive.shape);
+				const auto& vertices = polygon->vertices();
+				const auto& normals = polygon->normals();
+				if (vertices.size() > MaxHullVertices || normals.size() != vertices.size())
+					return false;
+				hull.count = vertices.size();
+				for (size_t i = 0; i < hull.count; ++i)
+				{
+					hull.vertices[i] = rotation.multiply(vertices[i]) * transform.scale + transform.position;
+					hull.normals[i] = rotation.multiply(normals[i]);
+				}
+				hull.radius = 0;
+				return true;
+			}
+			if (primitive.shape->type() == ShapeType::Capsule)
+			{
+				//a capsule is a segment along its longer side grown by half of the shorter side
+				auto capsule = static_cast<const Capsule*>(primitive.shape);
+				const real halfWidth = capsule->halfWidth();
+				const real halfHeight = capsule->halfHeight();
+				Vector2 axis(0, 1);
+				real halfLength = halfHeight - halfWidth;
+				real radius = halfWidth;
+				if (halfWidth >= halfHeight)
+				{
+					axis.set(1, 0);
+					halfLength = halfWidth - halfHeight;
+					radius = halfHeight;
+				}
+				axis = rotation.multiply(axis);
+				hull.count = 2;
+				hull.vertices[0] = transform.position - axis * (halfLength * transform.scale);
+				hull.vertices[1] = transform.position + axis * (halfLength * transform.scale);
+				hull.normals[0] = axis.perpendicular();
+				hull.normals[1] = -hull.normals[0];
+				hull.radius = radius * transform.scale;
+				return true;
+			}
+			return false;
+		}
+
+		//distance of hullB from face edge of hullA
+		real faceSeparation(const Hull& hullA, size_t edge, const Hull& hullB)
+		{
+			real separation = Constant::Max;
+			for (size_t j = 0; j < hullB.count; ++j)
+				separation = Math::min(separation, hullA.normals[edge].dot(hullB.vertices[j] - hullA.vertices[edge]));
+			return separation;
+		}
+
+		//largest distance of hullB from a face of hullA, negative when the cores overlap
+		real maxSeparation(const Hull& hullA, const Hull& hullB, size_t& edge)
+		{
+			real best = -Constant::Max;
+			edge = 0;
+			for (size_t i = 0; i < hullA.count; ++i)
+			{
+				const real separation = faceSeparation(hullA, i, hullB);
+				if (separation > best)
+				{
+					best = separation;
+					edge = i;
+				}
+			}
+			return best;
+		}
+
+		//closest points of segments p1p2 and q1q2 as fractions s and t along them
+		void closestSegmentPoints(const Vector2& p1, const Vector2& p2, const Vector2& q1, const Vector2& q2,
+		                          real& s, real& t)
+		{
+			const Vector2 d1 = p2 - p1;
+			const Vector2 d2 = q2 - q1;
+			const Vector2 r = p1 - q1;
+			const real a = d1.lengthSquare();
+			const real e = d2.lengthSquare();
+			const real f = d2.dot(r);
+			s = 0;
+			t = 0;
+			if (a <= Constant::Epsilon && e <= Constant::Epsilon)
+				return;
+			if (a <= Constant::Epsilon)
+			{
+				t = Math::clamp(f / e, 0.0f, 1.0f);
+				return;
+			}
+			const real c = d1.dot(r);
+			if (e <= Constant::Epsilon)
+			{
+				s = Math::clamp(-c / a, 0.0f, 1.0f);
+				return;
+			}
+			const real b = d1.dot(d2);
+			const real denominator = a * e - b * b;
+			if (denominator > Constant::Epsilon)
+				s = Math::clamp((b * f - c * e) / denominator, 0.0f, 1.0f);
+			t = (b * s + f) / e;
+			if (t < 0)
+			{
+				t = 0;
+				s = Math::clamp(-c / a, 0.0f, 1.0f);
+			}
+			else if (t > 1)
+			{
+				t = 1;
+				s = Math::clamp((b - c) / a, 0.0f, 1.0f);
+			}
+		}
+
+		//how a hull contact point came about, part of its feature id
+		enum class HullFeature : uint64_t
+		{
+			//an incident vertex against the reference face
+			FaceVertex,
+			//the incident face clipped by a side plane at a reference vertex
+			VertexFace,
+			//two vertices of separated cores
+			VertexVertex
+		};
+
+		//reference and incident are the indices of the reference and incident vertex or face
+		uint64_t hullContactId(HullFeature feature, bool flip, size_t reference, size_t incident)
+		{
+			return static_cast<uint64_t>(flip) << 34 | static_cast<uint64_t>(feature) << 32 |
+				static_cast<uint64_t>(reference) << 16 | static_cast<uint64_t>(incident);
+		}
+
+		//contact of a core point of the incident hull against the surface of the reference hull.
+		//normal is the outward normal of the reference hull, points are handed out as A then B
+		void addHullContact(const Vector2& referencePoint, const Vector2& incidentPoint, const Vector2& normal,
+		                    const Hull& reference, const Hull& incident, bool flip, uint64_t id, ContactPair& pair)
+		{
+			const Vector2 onReference = referencePoint + normal * reference.radius;
+			const Vector2 onIncident = incidentPoint - normal * incident.radius;
+			if (flip)
+				pair.addContact(onIncident, onReference, id);
+			else
+				pair.addContact(onReference, onIncident, id);
+		}
+
+		//clip the incident edge against the side planes of the reference edge and keep the penetrating points
+		void clipHulls(const Hull& reference, size_t referenceEdge, const Hull& incident, size_t incidentEdge,
+		               bool flip, Collision& result)
+		{
+			const Vector2& normal = reference.normals[referenceEdge];
+			const Vector2& v11 = reference.vertices[referenceEdge];
+			const Vector2& v12 = reference.vertices[(referenceEdge + 1) % reference.count];
+			const Vector2 tangent = normal.perpendicular();
+
+			real lower1 = 0;
+			real upper1 = tangent.dot(v12 - v11);
+			size_t lowerReference = referenceEdge;
+			size_t upperReference = (referenceEdge + 1) % reference.count;
+			if (upper1 < lower1)
+			{
+				std::swap(lower1, upper1);
+				std::swap(lowerReference, upperReference);
+			}
+
+			size_t lowerIncident = incidentEdge;
+			size_t upperIncident = (incidentEdge + 1) % incident.count;
+			Vector2 lowerVertex = incident.vertices[lowerIncident];
+			Vector2 upperVertex = incident.vertices[upperIncident];
+			real lower2 = tangent.dot(lowerVertex - v11);
+			real upper2 = tangent.dot(upperVertex - v11);
+			if (upper2 < lower2)
+			{
+				std::swap(lowerVertex, upperVertex);
+				std::swap(lower2, upper2);
+				std::swap(lowerIncident, upperIncident);
+			}
+
+			const real span = upper2 - lower2;
+			Vector2 clipped[2] = {lowerVertex, upperVertex};
+			uint64_t ids[2] = {
+				hullContactId(HullFeature::FaceVertex, flip, referenceEdge, lowerIncident),
+				hullContactId(HullFeature::FaceVertex, flip, referenceEdge, upperIncident)
+			};
+			if (span > Constant::Epsilon)
+			{
+				if (lower2 < lower1)
+				{
+					clipped[0] = lowerVertex + (upperVertex - lowerVertex) * ((lower1 - lower2) / span);
+					ids[0] = hullContactId(HullFeature::VertexFace, flip, lowerReference, incidentEdge);
+				}
+				if (upper2 > upper1)
+				{
+					clipped[1] = lowerVertex + (upperVertex - lowerVertex) * ((upper1 - lower2) / span);
+					ids[1] = hullContactId(HullFeature::VertexFace, flip, upperReference, incidentEdge);
+				}
+			}
+
+			const real radius = reference.radius + incident.radius;
+			for (size_t i = 0; i < 2; ++i)
+			{
+				const real separation = normal.dot(clipped[i] - v11);
+				if (separation > radius)
+					continue;
+				addHullContact(clipped[i] - normal * separation, clipped[i], normal, reference, incident, flip, ids[i],
+				               result.contactList);
+			}
+		}
+
+		void collideHulls(const Hull& hullA, const Hull& hullB, Collision& result, CollisionCache* cache)
+		{
+			const real radius = hullA.radius + hullB.radius;
+			//a face that separated the pair in the last step most likely still does
+			if (cache != nullptr && cache->separatingFace != UINT32_MAX)
+			{
+				const bool onB = cache->separatingHull == 1;
+				const Hull& reference = onB ? hullB : hullA;
+				if (cache->separatingFace < reference.count &&
+					faceSeparation(reference, cache->separatingFace, onB ? hullA : hullB) > radius)
+					return;
+			}
+
+			size_t edgeA = 0;
+			size_t edgeB = 0;
+			const real separationA = maxSeparation(hullA, hullB, edgeA);
+			const real separationB = maxSeparation(hullB, hullA, edgeB);
+			if (cache != nullptr)
+			{
+				cache->separatingHull = separationB > separationA ? 1 : 0;
+				cache->separatingFace = static_cast<Index>(separationB > separationA ? edgeB : edgeA);
+			}
+			if (separationA > radius || separationB > radius)
+				return;
+
+			//prefer a face of A so that the reference face does not flicker between nearly equal candidates
+			const bool flip = separationB > separationA + LinearTolerance;
+			const Hull& reference = flip ? hullB : hullA;
+			const Hull& incident = flip ? hullA : hullB;
+			const size_t referenceEdge = flip ? edgeB : edgeA;
+			const real separation = flip ? separationB : separationA;
+			const Vector2& normal = reference.normals[referenceEdge];
+
+			//incident edge is the one that faces the reference normal the most
+			size_t incidentEdge = 0;
+			real minDot = Constant::Max;
+			for (size_t i = 0; i < incident.count; ++i)
+			{
+				const real dot = normal.dot(incident.normals[i]);
+				if (dot < minDot)
+				{
+					minDot = dot;
+					incidentEdge = i;
+				}
+			}
+
+			if (separation > LinearTolerance)
+			{
+				//the cores are apart and only the rounded parts touch, which may happen between two vertices
+				const Vector2& v11 = reference.vertices[referenceEdge];
+				const Vector2& v12 = reference.vertices[(referenceEdge + 1) % reference.count];
+				const Vector2& v21 = incident.vertices[incidentEdge];
+				const Vector2& v22 = incident.vertices[(incidentEdge + 1) % incident.count];
+				real s = 0;
+				real t = 0;
+				closestSegmentPoints(v11, v12, v21, v22, s, t);
+				if ((s == 0 || s == 1) && (t == 0 || t == 1))
+				{
+					const Vector2 referencePoint = s == 0 ? v11 : v12;
+					const Vector2 incidentPoint = t == 0 ? v21 : v22;
+					const real distance = (incidentPoint - referencePoint).length();
+					if (distance > radius)
+						return;
+					const Vector2 direction = (incidentPoint - referencePoint) / distance;
+					const size_t referenceVertex = s == 0 ? referenceEdge : (referenceEdge + 1) % reference.count;
+					const size_t incidentVertex = t == 0 ? incidentEdge : (incidentEdge + 1) % incident.count;
+					addHullContact(referencePoint, incidentPoint, direction, reference, incident, flip,
+					               hullContactId(HullFeature::VertexVertex, flip, referenceVertex, incidentVertex),
+					               result.contactList);
+					result.normal = flip ? direction : -direction;
+					result.penetration = radius - distance;
+					return;
+				}
+			}
+
+			clipHulls(reference, referenceEdge, incident, incidentEdge, flip, result);
+			result.normal = flip ? normal : -normal;
+			result.penetration = radius - separation;
+		}
+
+		//hull is shape A, the circle is shape B
+		void collideHullCircle(const Hull& hull, const Vector2& center, real circleRadius, Collision& result,
+		                       CollisionCache* cache)
+		{
+			const real radius = hull.radius + circleRadius;
+			if (cache != nullptr && cache->separatingFace < hull.count &&
+				hull.normals[cache->separatingFace].dot(center - hull.vertices[cache->separatingFace]) > radius)
+				return;
+
+			size_t edge = 0;
+			real separation = -Constant::Max;
+			for (size_t i = 0; i < hull.count; ++i)
+			{
+				const real distance = hull.normals[i].dot(center - hull.vertices[i]);
+				if (distance > separation)
+				{
+					separation = distance;
+					edge = i;
+				}
+			}
+			if (cache != nullptr)
+				cache->separatingFace = static_cast<Index>(edge);
+			if (separation > radius)
+				return;
+
+			const Vector2& v1 = hull.vertices[edge];
+			const Vector2& v2 = hull.vertices[(edge + 1) % hull.count];
+			Vector2 outward = hull.normals[edge];
+			Vector2 closest = center - outward * separation;
+			real distance = separation;
+			if (separation > 0)
+			{
+				//the center may be closer to one of the vertices than to the face
+				const bool region1 = (center - v1).dot(v2 - v1) <= 0;
+				const bool region2 = (center - v2).dot(v1 - v2) <= 0;
+				if (region1 || region2)
+				{
+					closest = region1 ? v1 : v2;
+					distance = (center - closest).length();
+					if (distance > radius)
+						return;
+					if (distance > Constant::Epsilon)
+						outward = (center - closest) / distance;
+				}
+			}
+
+			result.normal = -outward;
+			result.penetration = radius - distance;
+			//a single point with one id, it keeps its impulse while the circle rolls from a face over a vertex
+			result.contactList.addContact(closest + outward * hull.radius, center - outward * circleRadius);
+		}
+	}
+
+	bool Detector::detectAnalytic(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, Collision& result,
+	                              CollisionCache* cache)
+	{
+		const ShapeType typeA = shapeA.shape->type();
+		const ShapeType typeB = shapeB.shape->type();
+		auto supported = [](ShapeType type)
+		{
+			return type == ShapeType::Polygon || type == ShapeType::Capsule || type == ShapeType::Circle;
+		};
+		if (!supported(typeA) || !supported(typeB))
+			return false;
+
+		if (typeA == ShapeType::Circle && typeB == ShapeType::Circle)
+		{
+			const real radiusA = static_cast<const Circle*>(shapeA.shape)->radius() * shapeA.transform.scale;
+			const real radiusB = static_cast<const Circle*>(shapeB.shape)->radius() * shapeB.transform.scale;
+			const Vector2 direction = shapeA.transform.position - shapeB.transform.position;
+			const real distance = direction.length();
+			const real radius = radiusA + radiusB;
+			if (distance > radius)
+				return true;
+			//concentric circles have no preferred direction, push A up
+			const Vector2 normal = distance > Constant::Epsilon ? direction / distance : Vector2(0, 1);
+			result.normal = normal;
+			result.penetration = radius - distance;
+			result.contactList.addContact(shapeA.transform.position - normal * radiusA,
+			                              shapeB.transform.position + normal * radiusB);
+		}
+		else if (typeA == ShapeType::Circle || typeB == ShapeType::Circle)
+		{
+			const bool swap = typeA == ShapeType::Circle;
+			const ShapePrimitive& hullShape = swap ? shapeB : shapeA;
+			const ShapePrimitive& circleShape = swap ? shapeA : shapeB;
+			Hull hull;
+			if (!makeHull(hullShape, hull))
+				return false;
+			collideHullCircle(hull, circleShape.transform.position,
+			                  static_cast<const Circle*>(circleShape.shape)->radius() * circleShape.transform.scale,
+			                  result, cache);
+			if (swap)
+			{
+				result.normal.negate();
+				std::swap(result.contactList.points[0], result.contactList.points[1]);
+			}
+		}
+		else
+		{
+			Hull hullA;
+			Hull hullB;
+			if (!makeHull(shapeA, hullA) || !makeHull(shapeB, hullB))
+				return false;
+			collideHulls(hullA, hullB, result, cache);
+		}
+
+		//touching is not colliding, same as the gjk path
+		result.isColliding = result.contactList.count > 0 && !realEqual(result.penetration, 0);
+		if (!result.isColliding)
+			result = Collision();
+		return true;
+	}
 
 	bool Detector::collide(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB)
 	{
@@ -18,11 +441,11 @@ namespace Physics2D
 
 		ShapePrimitive shapeA, shapeB;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
 		return collide(shapeA, shapeB);
@@ -33,7 +456,7 @@ namespace Physics2D
 
 		ShapePrimitive shapeB;
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
 		return collide(shapeA, shapeB);
@@ -44,12 +467,13 @@ namespace Physics2D
 
 		ShapePrimitive shapeA;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 		return collide(shapeA, shapeB);
 	}
-	Collision Detector::detect(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB)
+	Collision Detector::detect(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, CollisionCache* cache,
+	                           bool analytic, bool typed)
 	{
 		Collision result;
 		assert(shapeA.shape != nullptr && shapeB.shape != nullptr);
@@ -58,43 +482,21 @@ namespace Physics2D
 		if (shapeA.shape->type() == ShapeType::Edge && shapeB.shape->type() == ShapeType::Edge)
 			return result;
 
-		//check if two circle
-		//if (shapeA.shape->type() == ShapeType::Circle && shapeB.shape->type() == ShapeType::Circle)
-		//{
-		//	const Circle* circleA = static_cast<Circle*>(shapeA.shape);
-		//	const Circle* circleB = static_cast<Circle*>(shapeB.shape);
-		//	const Vector2 dir = shapeA.transform.position - shapeB.transform.position;
-		//	const real distance = dir.length();
-		//	const Vector2 normal = dir.normal();
-
-		//	const real radius = circleA->radius() + circleB->radius();
-		//	if (distance > radius)
-		//		return result;
+		if (cache != nullptr)
+			cache->gjk = false;
 
-		//	result.isColliding = true;
-		//	result.normal = normal;
-		//	result.penetration = radius - distance;
-		//	result.contactList.addContact(shapeA.transform.position - normal * circleA->radius(), shapeB.transform.position + normal * circleB->radius());
-
-		//	return result;
-		//}
-
-		Simplex simplex = Narrowphase::gjk(shapeA, shapeB);
-		bool isColliding = simplex.isContainOrigin;
-
-		if (shapeA.transform.position.fuzzyEqual(shapeB.transform.position) && !isColliding)
-			isColliding = simplex.containsOrigin(true);
+		if (analytic && detectAnalytic(shapeA, shapeB, result, cache))
+			return result;
 
-		if (isColliding)
+		Narrowphase::CollideKernel kernel = &Narrowphase::collide;
+		if (typed)
+			kernel = Narrowphase::collideKernel(shapeA.shape->type(), shapeB.shape->type());
+		CollisionInfo info;
+		if (kernel(shapeA, shapeB, info, result.contactList, cache))
 		{
-			CollisionInfo info = Narrowphase::epa(simplex, shapeA, shapeB);
+			result.isColliding = true;
 			result.normal = info.normal;
-			result.isColliding = isColliding;
 			result.penetration = info.penetration;
-			if (!realEqual(result.penetration, 0))
-				result.contactList = Narrowphase::generateContacts(shapeA, shapeB, info);
-			else
-				result.isColliding = false;
 		}
 
 		return result;
@@ -107,7 +509,7 @@ namespace Physics2D
 
 		ShapePrimitive shapeA;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 
@@ -126,7 +528,7 @@ namespace Physics2D
 
 		ShapePrimitive shapeB;
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
 		result = detect(shapeA, shapeB);
@@ -135,7 +537,7 @@ namespace Physics2D
 
 		return result;
 	}
-	Collision Detector::detect(Body* bodyA, Body* bodyB)
+	Collision Detector::detect(Body* bodyA, Body* bodyB, CollisionCache* cache, bool analytic, bool typed)
 	{
 		Collision result;
 
@@ -154,19 +556,73 @@ namespace Physics2D
 
 		ShapePrimitive shapeA, shapeB;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
-		result = detect(shapeA, shapeB);
+		result = detect(shapeA, shapeB, cache, analytic, typed);
 		result.bodyA = bodyA;
 		result.bodyB = bodyB;
 
 		return result;
 	}
+	Collision Detector::speculate(Body* bodyA, Body* bodyB, const real& margin)
+	{
+		Collision result;
+
+		assert(bodyA != nullptr && bodyB != nullptr);
+
+		if (bodyA == bodyB)
+			return result;
+
+		if (bodyA->id() > bodyB->id())
+			std::swap(bodyA, bodyB);
+
+		ShapePrimitive shapeA, shapeB;
+		shapeA.shape = bodyA->shape();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
+		shapeA.transform.position = bodyA->position();
+
+		shapeB.shape = bodyB->shape();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
+		shapeB.transform.position = bodyB->position();
+
+		//the gap along the closest points, measured between support points like the toi search does,
+		//since gjk distance of round shapes may come out too long
+		const CollisionInfo info = Narrowphase::gjkDistance(shapeA, shapeB);
+		const Vector2 direction = info.pair.pointA - info.pair.pointB;
+		if (direction.fuzzyEqual({0, 0}))
+			return result;
+		const Vector2 normal = direction.normal();
+		const real gap = Vector2::dotProduct(Narrowphase::findFurthestPoint(shapeA, normal.negative()).first, normal) -
+			Vector2::dotProduct(Narrowphase::findFurthestPoint(shapeB, normal).first, normal);
+		if (gap >= margin)
+			return result;
+
+		//move A over the gap and a little into B, so that the usual contact generation builds the manifold and its
+		//feature ids. the points on A are moved back afterwards. the gap along a normal that is slightly off, as
+		//for long shapes, falls short of the distance, the shift covers both
+		const real shift = Math::max(Math::max(gap, direction.length()), real(0)) + SpeculativeOverlap;
+		shapeA.transform.position -= normal * shift;
+		result = detect(shapeA, shapeB);
+		if (!result.isColliding)
+			return Collision();
+		for (uint32_t i = 0; i < result.contactList.count; i += 2)
+		{
+			result.contactList.points[i] += normal * shift;
+			//contact generation went for another normal than the one A was moved along, the points do not say
+			//how far the shapes are apart
+			if ((result.contactList.points[i] - result.contactList.points[i + 1]).dot(result.normal) < -SpeculativeOverlap)
+				return Collision();
+		}
+		result.penetration = -Math::max(gap, real(0));
+		result.bodyA = bodyA;
+		result.bodyB = bodyB;
+		return result;
+	}
 	CollisionInfo Detector::distance(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB)
 	{
 		assert(shapeA.shape != nullptr && shapeB.shape != nullptr);
@@ -178,7 +634,7 @@ namespace Physics2D
 
 		ShapePrimitive shapeA;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 		return Narrowphase::gjkDistance(shapeA, shapeB);
@@ -189,7 +645,7 @@ namespace Physics2D
 
 		ShapePrimitive shapeB;
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
 		return Narrowphase::gjkDistance(shapeA, shapeB);
@@ -205,11 +661,11 @@ namespace Physics2D
 
 		ShapePrimitive shapeA, shapeB;
 		shapeA.shape = bodyA->shape();
-		shapeA.transform.rotation = bodyA->rotation();
+		shapeA.transform.setRotation(bodyA->rotation(), bodyA->rotationMatrix());
 		shapeA.transform.position = bodyA->position();
 
 		shapeB.shape = bodyB->shape();
-		shapeB.transform.rotation = bodyB->rotation();
+		shapeB.transform.setRotation(bodyB->rotation(), bodyB->rotationMatrix());
 		shapeB.transform.position = bodyB->position();
 
 		return Narrowphase::gjkDistance(shapeA, shapeB);
@@ -1,23 +1,361 @@
 #include "physics2d_narrowphase.h"
+#include "physics2d_simd.h"
 
+#include <algorithm>
 #include <iostream>
+#include <new>
 
 namespace Physics2D
 {
+	namespace
+	{
+		//support point of one shape type in world space and the index of the vertex it came from.
+		//the Shape version goes through the type switch, the others are picked at compile time
+		template <typename T>
+		std::pair<Vector2, Index> furthestPoint(const ShapePrimitive& shape, const Vector2& direction, Index start);
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Polygon>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index start)
+		{
+			auto polygon = static_cast<const Polygon*>(shape.shape);
+			auto [target, index] = Narrowphase::findFurthestPoint(*polygon, shape.transform.inverseRotatePoint(direction),
+			                                                      start);
+			target = shape.transform.rotationMatrix().multiply(target) + shape.transform.position;
+			return std::make_pair(target, index);
+		}
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Circle>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index)
+		{
+			auto circle = static_cast<const Circle*>(shape.shape);
+			return std::make_pair(direction.normal() * circle->radius() + shape.transform.position, UINT32_MAX);
+		}
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Ellipse>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index)
+		{
+			auto ellipse = static_cast<const Ellipse*>(shape.shape);
+			Vector2 target = GeometryAlgorithm2D::calculateEllipseProjectionPoint(
+				ellipse->A(), ellipse->B(), shape.transform.inverseRotatePoint(direction));
+			target = shape.transform.rotationMatrix().multiply(target) + shape.transform.position;
+			return std::make_pair(target, UINT32_MAX);
+		}
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Edge>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index)
+		{
+			auto edge = static_cast<const Edge*>(shape.shape);
+			const real dot1 = Vector2::dotProduct(edge->startPoint(), direction);
+			const real dot2 = Vector2::dotProduct(edge->endPoint(), direction);
+			Vector2 target = dot1 > dot2 ? edge->startPoint() : edge->endPoint();
+			target = shape.transform.rotationMatrix().multiply(target) + shape.transform.position;
+			return std::make_pair(target, UINT32_MAX);
+		}
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Capsule>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index)
+		{
+			auto capsule = static_cast<const Capsule*>(shape.shape);
+			Vector2 target = GeometryAlgorithm2D::calculateCapsuleProjectionPoint(
+				capsule->halfWidth(), capsule->halfHeight(), shape.transform.inverseRotatePoint(direction));
+			Index index = 0;
+			const Vector2 test(Math::abs(target.x), Math::abs(target.y));
+			const Vector2 topRight = capsule->topRight();
+			if (test.equal(topRight))
+				index = 1;
+			target = shape.transform.rotationMatrix().multiply(target) + shape.transform.position;
+			return std::make_pair(target, index);
+		}
+
+		template <>
+		inline std::pair<Vector2, Index> furthestPoint<Shape>(const ShapePrimitive& shape, const Vector2& direction,
+		                                                        Index start)
+		{
+			return Narrowphase::findFurthestPoint(shape, direction, start);
+		}
+
+		//world position of vertex index, false if the shape has no vertex there.
+		//only polygon indices name a vertex, the indices of the other shapes do not
+		template <typename T>
+		bool vertexAt(const ShapePrimitive&, Index, Vector2&)
+		{
+			return false;
+		}
+
+		template <>
+		inline bool vertexAt<Polygon>(const ShapePrimitive& shape, Index index, Vector2& vertex)
+		{
+			const auto& vertices = static_cast<const Polygon*>(shape.shape)->vertices();
+			if (index >= vertices.size())
+				return false;
+			vertex = shape.transform.rotationMatrix().multiply(vertices[index]) + shape.transform.position;
+			return true;
+		}
+
+		template <>
+		inline bool vertexAt<Shape>(const ShapePrimitive& shape, Index index, Vector2& vertex)
+		{
+			return shape.shape->type() == ShapeType::Polygon && vertexAt<Polygon>(shape, index, vertex);
+		}
+
+		//support of the minkowski difference A - B
+		template <typename ShapeA, typename ShapeB>
+		struct PairSupport
+		{
+			//support vertices of the last call, large polygons climb from there
+			Index start[2] = {UINT32_MAX, UINT32_MAX};
+
+			//minkowski vertex of a vertex of A and a vertex of B, used to rebuild a cached simplex
+			static bool vertex(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, const Index* index,
+			                   SimplexVertex& vertex)
+			{
+				if (!vertexAt<ShapeA>(shapeA, index[0], vertex.point[0]) ||
+					!vertexAt<ShapeB>(shapeB, index[1], vertex.point[1]))
+					return false;
+				vertex.index[0] = index[0];
+				vertex.index[1] = index[1];
+				vertex.result = vertex.point[0] - vertex.point[1];
+				return true;
+			}
+
+			SimplexVertex support(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, const Vector2& direction)
+			{
+				SimplexVertex vertex;
+				std::tie(vertex.point[0], vertex.index[0]) = furthestPoint<ShapeA>(shapeA, direction, start[0]);
+				std::tie(vertex.point[1], vertex.index[1]) = furthestPoint<ShapeB>(shapeB, direction.negative(), start[1]);
+				vertex.result = vertex.point[0] - vertex.point[1];
+				start[0] = vertex.index[0];
+				start[1] = vertex.index[1];
+				return vertex;
+			}
+		};
+
+		using SwitchSupport = PairSupport<Shape, Shape>;
+
+		//lanes closer than their radius plus this are left to the scalar path, covers the float rounding of the batch
+		constexpr float BatchSeparationMargin = 1e-3f;
+		//squared distance to the origin that has to be gained per iteration, relative to the current one
+		constexpr float BatchConvergence = 1e-4f;
+
+		using LaneVertices = float[GjkBatch::MaxVertices][GjkBatch::LaneCount];
+
+		//convex core of a shape in world space and its radius, false if the shape has none that fits into a batch
+		bool batchCore(const ShapePrimitive& primitive, Vector2 (&core)[GjkBatch::MaxVertices], size_t& count,
+		               real& radius)
+		{
+			const Transform& transform = primitive.transform;
+			radius = 0;
+			switch (primitive.shape->type())
+			{
+			case ShapeType::Polygon:
+			{
+				const auto& vertices = static_cast<const Polygon*>(primitive.shape)->vertices();
+				if (vertices.empty() || vertices.size() > GjkBatch::MaxVertices)
+					return false;
+				count = vertices.size();
+				for (size_t i = 0; i < count; ++i)
+					core[i] = transform.translatePoint(vertices[i]);
+				return true;
+			}
+			case ShapeType::Edge:
+			{
+				auto edge = static_cast<const Edge*>(primitive.shape);
+				count = 2;
+				core[0] = transform.translatePoint(edge->startPoint());
+				core[1] = transform.translatePoint(edge->endPoint());
+				return true;
+			}
+			case ShapeType::Capsule:
+			{
+				//the segment along the longer side grown by half of the shorter side
+				auto capsule = static_cast<const Capsule*>(primitive.shape);
+				const real halfWidth = capsule->halfWidth();
+				const real halfHeight = capsule->halfHeight();
+				const bool wide = halfWidth >= halfHeight;
+				const Vector2 axis = wide ? Vector2(halfWidth - halfHeight, 0) : Vector2(0, halfHeight - halfWidth);
+				count = 2;
+				core[0] = transform.translatePoint(-axis);
+				core[1] = transform.translatePoint(axis);
+				radius = (wide ? halfHeight : halfWidth) * transform.scale;
+				return true;
+			}
+			case ShapeType::Circle:
+				count = 1;
+				core[0] = transform.position;
+				radius = static_cast<const Circle*>(primitive.shape)->radius() * transform.scale;
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		//vertex of every lane that lies furthest along the direction
+		void laneSupport(const LaneVertices& x, const LaneVertices& y, size_t count, const Float4& dx,
+		                 const Float4& dy, Float4& px, Float4& py)
+		{
+			px = Float4::load(x[0]);
+			py = Float4::load(y[0]);
+			Float4 best = px * dx + py * dy;
+			for (size_t i = 1; i < count; ++i)
+			{
+				const Float4 vx = Float4::load(x[i]);
+				const Float4 vy = Float4::load(y[i]);
+				const Float4 dot = vx * dx + vy * dy;
+				const Float4 further = lessThan(best, dot);
+				px = select(further, vx, px);
+				py = select(further, vy, py);
+				best = max(best, dot);
+			}
+		}
+
+		//gjk simplex of every lane, vertices past count are unused
+		struct LaneSimplex
+		{
+			Float4 x[3];
+			Float4 y[3];
+			Float4 count;
+			//point of the simplex closest to the origin
+			Float4 vx;
+			Float4 vy;
+		};
+
+		inline Float4 laneCross(const Float4& ax, const Float4& ay, const Float4& bx, const Float4& by)
+		{
+			return ax * by - ay * bx;
+		}
+
+		//reduce the simplex of the active lanes to the voronoi region of the origin, branch free.
+		//enclosed is set for lanes whose triangle contains the origin
+		void solveLanes(LaneSimplex& simplex, const Float4& active, Float4& enclosed)
+		{
+			const Float4 zero = Float4::set(0.0f);
+			const Float4& x1 = simplex.x[0];
+			const Float4& y1 = simplex.y[0];
+			const Float4& x2 = simplex.x[1];
+			const Float4& y2 = simplex.y[1];
+			const Float4& x3 = simplex.x[2];
+			const Float4& y3 = simplex.y[2];
+			const Float4 three = andNot(lessThan(simplex.count, Float4::set(2.5f)), active);
+			const Float4 two = andNot(three, active);
+
+			//barycentric coordinates of the origin on every edge and on the triangle
+			const Float4 e12x = x2 - x1;
+			const Float4 e12y = y2 - y1;
+			const Float4 d12_1 = x2 * e12x + y2 * e12y;
+			const Float4 d12_2 = -(x1 * e12x + y1 * e12y);
+			const Float4 e13x = x3 - x1;
+			const Float4 e13y = y3 - y1;
+			const Float4 d13_1 = x3 * e13x + y3 * e13y;
+			const Float4 d13_2 = -(x1 * e13x + y1 * e13y);
+			const Float4 e23x = x3 - x2;
+			const Float4 e23y = y3 - y2;
+			const Float4 d23_1 = x3 * e23x + y3 * e23y;
+			const Float4 d23_2 = -(x2 * e23x + y2 * e23y);
+			const Float4 n123 = laneCross(e12x, e12y, e13x, e13y);
+			const Float4 d123_1 = n123 * laneCross(x2, y2, x3, y3);
+			const Float4 d123_2 = n123 * laneCross(x3, y3, x1, y1);
+			const Float4 d123_3 = n123 * laneCross(x1, y1, x2, y2);
+
+			//every lane takes the first region that holds, in the order of the scalar solver
+			Float4 taken = zero;
+			auto claim = [&taken](const Float4& region)
+			{
+				const Float4 result = andNot(taken, region);
+				taken = taken | result;
+				return result;
+			};
+			const Float4 vertex1 = claim((two & lessEqual(d12_2, zero)) |
+				(three & lessEqual(d12_2, zero) & lessEqual(d13_2, zero)));
+			const Float4 edge12 = claim(three & lessThan(zero, d12_1) & lessThan(zero, d12_2) & lessEqual(d123_3, zero));
+			const Float4 edge13 = claim(three & lessThan(zero, d13_1) & lessThan(zero, d13_2) & lessEqual(d123_2, zero));
+			const Float4 vertex2 = claim((two & lessEqual(d12_1, zero)) |
+				(three & lessEqual(d12_1, zero) & lessEqual(d23_2, zero)));
+			const Float4 vertex3 = claim(three & lessEqual(d13_1, zero) & lessEqual(d23_1, zero));
+			const Float4 edge23 = claim(three & lessThan(zero, d23_1) & lessThan(zero, d23_2) & lessEqual(d123_1, zero));
+			const Float4 segment = edge12 | claim(two);
+			enclosed = claim(three);
+
+			//the kept vertices move to the front, an edge keeps its weights for the closest point
+			const Float4 edge = segment | edge13 | edge23;
+			const Float4 vertex = vertex1 | vertex2 | vertex3;
+			const Float4 nx1 = select(vertex2 | edge23, x2, select(vertex3, x3, x1));
+			const Float4 ny1 = select(vertex2 | edge23, y2, select(vertex3, y3, y1));
+			const Float4 nx2 = select(edge13 | edge23, x3, x2);
+			const Float4 ny2 = select(edge13 | edge23, y3, y2);
+			const Float4 weight1 = select(segment, d12_1, select(edge13, d13_1, d23_1));
+			const Float4 weight2 = select(segment, d12_2, select(edge13, d13_2, d23_2));
+			const Float4 sum = weight1 + weight2;
+
+			simplex.x[0] = select(vertex | edge, nx1, x1);
+			simplex.y[0] = select(vertex | edge, ny1, y1);
+			simplex.x[1] = select(edge, nx2, x2);
+			simplex.y[1] = select(edge, ny2, y2);
+			simplex.count = select(vertex, Float4::set(1.0f), select(edge, Float4::set(2.0f), simplex.count));
+			simplex.vx = select(edge, (weight1 * nx1 + weight2 * nx2) / sum, select(vertex, nx1, simplex.vx));
+			simplex.vy = select(edge, (weight1 * ny1 + weight2 * ny2) / sum, select(vertex, ny1, simplex.vy));
+		}
+	}
+
 	Simplex Narrowphase::gjk(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, const size_t& iteration)
+	{
+		SwitchSupport support;
+		return gjkKernel(support, shapeA, shapeB, iteration);
+	}
+
+	template <typename Support>
+	Simplex Narrowphase::gjkKernel(Support& support, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
+	                               const size_t& iteration, CollisionCache* cache)
 	{
 		Simplex simplex;
 
+		if (cache != nullptr)
+		{
+			cache->gjk = true;
+			cache->iterations = 1;
+			support.start[0] = cache->supportIndex[0];
+			support.start[1] = cache->supportIndex[1];
+		}
+
+		//the simplex of the last step usually still contains the origin, then no support point is needed
+		if (cache != nullptr && cache->simplexCount == 3)
+		{
+			for (size_t i = 0; i < 3; ++i)
+			{
+				SimplexVertex vertex;
+				if (!Support::vertex(shapeA, shapeB, cache->simplexIndex[i], vertex))
+					break;
+				simplex.addSimplexVertex(vertex);
+			}
+			const real area = simplex.count == 3
+				                  ? (simplex.vertices[1].result - simplex.vertices[0].result).cross(
+					                  simplex.vertices[2].result - simplex.vertices[0].result)
+				                  : 0.0f;
+			if (std::fabs(area) > Constant::GeometryEpsilon)
+			{
+				reconstructSimplexByVoronoi(simplex);
+				if (simplex.isContainOrigin)
+					return simplex;
+			}
+			simplex.removeAll();
+		}
+
 		Vector2 direction = shapeB.transform.position - shapeA.transform.position;
+		if (cache != nullptr && cache->hasAxis)
+			direction = cache->axis;
 
 		if (direction.fuzzyEqual({0, 0}))
 			direction.set(1, 1);
 		//first
-		SimplexVertex vertex = support(shapeA, shapeB, direction);
+		SimplexVertex vertex = support.support(shapeA, shapeB, direction);
 		simplex.addSimplexVertex(vertex);
 		//second
 		direction.negate();
-		vertex = support(shapeA, shapeB, direction);
+		vertex = support.support(shapeA, shapeB, direction);
 		simplex.addSimplexVertex(vertex);
 
 		//check 1d simplex(line segment) across origin
@@ -26,7 +364,7 @@ namespace Physics2D
 		//try to reconfigure simplex to avoid 1d simplex cross origin
 		if (simplex.containsOrigin())
 		{
-			const bool result = perturbSimplex(simplex, shapeA, shapeB, direction);
+			const bool result = perturbSimplex(support, simplex, shapeA, shapeB, direction);
 			if (!result)
 				assert(false && "Cannot reconstruct simplex.");
 		}
@@ -36,7 +374,7 @@ namespace Physics2D
 		{
 			//default closest edge is index 0 and index 1
 			direction = findDirectionByEdge(simplex.vertices[0], simplex.vertices[1], true);
-			vertex = support(shapeA, shapeB, direction);
+			vertex = support.support(shapeA, shapeB, direction);
 
 			//find repeated vertex
 			if (simplex.contains(vertex))
@@ -49,16 +387,51 @@ namespace Physics2D
 			simplex.addSimplexVertex(vertex);
 
 			reconstructSimplexByVoronoi(simplex);
+			if (cache != nullptr)
+				cache->iterations = iter + 1;
 			if (simplex.isContainOrigin)
-				return simplex;
+				break;
 
 			simplex.removeEnd();
 		}
+
+		if (cache != nullptr)
+		{
+			cache->axis = direction;
+			cache->hasAxis = true;
+			cache->supportIndex[0] = support.start[0];
+			cache->supportIndex[1] = support.start[1];
+			cache->simplexCount = 0;
+			if (simplex.isContainOrigin && simplex.count == 3)
+			{
+				bool indexed = true;
+				for (size_t i = 0; i < 3 && indexed; ++i)
+					indexed = simplex.vertices[i].isIndexAValid() && simplex.vertices[i].isIndexBValid();
+				if (indexed)
+				{
+					for (size_t i = 0; i < 3; ++i)
+					{
+						cache->simplexIndex[i][0] = simplex.vertices[i].index[0];
+						cache->simplexIndex[i][1] = simplex.vertices[i].index[1];
+					}
+					cache->simplexCount = 3;
+				}
+			}
+		}
 		return simplex;
 	}
 
 	CollisionInfo Narrowphase::epa(const Simplex& simplex, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-	                               const size_t& iteration, const real& epsilon)
+	                               const size_t& iteration, const real& epsilon, bool capturePolytope)
+	{
+		SwitchSupport support;
+		return epaKernel(support, simplex, shapeA, shapeB, iteration, epsilon, capturePolytope);
+	}
+
+	template <typename Support>
+	CollisionInfo Narrowphase::epaKernel(Support& support, const Simplex& simplex, const ShapePrimitive& shapeA,
+	                                     const ShapePrimitive& shapeB, const size_t& iteration, const real& epsilon,
+	                                     bool capturePolytope)
 	{
 		//return 1d simplex with edge closest to origin
 		CollisionInfo info;
@@ -66,23 +439,18 @@ namespace Physics2D
 		info.simplex.removeEnd();
 
 		//initiate polytope
+		Polytope polytope;
+		polytope.build(simplex);
 
-		//[Debug]
-		std::list<SimplexVertexWithOriginDistance>& polytope = info.polytope;
-		//std::list<SimplexVertexWithOriginDistance> polytope;
+		size_t iterStart = 0;
+		size_t iterTemp = 0;
 
-		buildPolytopeFromSimplex(polytope, simplex);
-
-		auto iterStart = polytope.begin();
-		auto iterEnd = polytope.end();
-		auto iterTemp = polytope.begin();
-
-		for (Index iter = 0; iter < iteration; ++iter)
+		for (Index iter = 0; iter < iteration && !polytope.full(); ++iter)
 		{
 			//indices of closest edge are set to 0 and 1
 			const Vector2 direction = findDirectionByEdge(info.simplex.vertices[0], info.simplex.vertices[1], false);
 
-			const SimplexVertex vertex = support(shapeA, shapeB, direction);
+			const SimplexVertex vertex = support.support(shapeA, shapeB, direction);
 
 			//cannot find any new vertex
 			if (info.simplex.contains(vertex))
@@ -103,19 +471,17 @@ namespace Physics2D
 			if (!validSide || !validVoronoi)
 				break;
 
-			auto itA = iterStart;
-
-			auto itB = itA;
-			polytopeIterNext(itB, polytope);
+			const size_t itA = iterStart;
+			const size_t itB = polytope.next(itA);
 
 			SimplexVertexWithOriginDistance pair;
 			pair.vertex = vertex;
-			const Vector2 t1 = GeometryAlgorithm2D::pointToLineSegment(itA->vertex.result, vertex.result, {0, 0});
+			const Vector2 t1 = GeometryAlgorithm2D::pointToLineSegment(polytope[itA].vertex.result, vertex.result, {0, 0});
 			const real dist1 = t1.lengthSquare();
-			const Vector2 t2 = GeometryAlgorithm2D::pointToLineSegment(vertex.result, itB->vertex.result, {0, 0});
+			const Vector2 t2 = GeometryAlgorithm2D::pointToLineSegment(vertex.result, polytope[itB].vertex.result, {0, 0});
 			const real dist2 = t2.lengthSquare();
 
-			itA->distance = dist1;
+			polytope[itA].distance = dist1;
 			pair.distance = dist2;
 			polytope.insert(itB, pair);
 
@@ -124,28 +490,25 @@ namespace Physics2D
 
 			//find shortest distance and set iterStart
 			real minDistance = Constant::Max;
-			auto iterTarget = iterStart;
+			size_t iterTarget = iterStart;
 			while (true)
 			{
-				if (iterTemp->distance < minDistance)
+				if (polytope[iterTemp].distance < minDistance)
 				{
-					minDistance = iterTemp->distance;
+					minDistance = polytope[iterTemp].distance;
 					iterTarget = iterTemp;
 				}
-				polytopeIterNext(iterTemp, polytope);
+				iterTemp = polytope.next(iterTemp);
 				if (iterTemp == iterStart)
 					break;
 			}
 			iterStart = iterTarget;
-			iterEnd = iterTarget;
-			polytopeIterPrev(iterEnd, polytope);
 
 			//set to begin
-			iterTemp = iterStart;
-			polytopeIterNext(iterTemp, polytope);
+			iterTemp = polytope.next(iterStart);
 			//reset simplex
-			info.simplex.vertices[0] = iterStart->vertex;
-			info.simplex.vertices[1] = iterTemp->vertex;
+			info.simplex.vertices[0] = polytope[iterStart].vertex;
+			info.simplex.vertices[1] = polytope[iterTemp].vertex;
 
 
 		}
@@ -154,6 +517,9 @@ namespace Physics2D
 		                                                              info.simplex.vertices[1].result
 		                                                              , {0, 0});
 
+		if (capturePolytope)
+			capture(polytope, info);
+
 		info.penetration = temp.length();
 		//assert(!realEqual(info.penetration, 0));
 		info.normal.clear();
@@ -174,56 +540,23 @@ namespace Physics2D
 		return vertex;
 	}
 
-	std::pair<Vector2, Index> Narrowphase::findFurthestPoint(const ShapePrimitive& shape, const Vector2& direction)
+	std::pair<Vector2, Index> Narrowphase::findFurthestPoint(const ShapePrimitive& shape, const Vector2& direction,
+	                                                         Index start)
 	{
-		Vector2 target;
-		Matrix2x2 rot(-shape.transform.rotation);
-		Vector2 rot_dir = rot.multiply(direction);
-		Index finalIndex = UINT32_MAX;
 		switch (shape.shape->type())
 		{
 		case ShapeType::Polygon:
-			{
-				auto polygon = static_cast<const Polygon*>(shape.shape);
-				std::tie(target, finalIndex) = findFurthestPoint(polygon->vertices(), rot_dir);
-				break;
-			}
+			return furthestPoint<Polygon>(shape, direction, start);
 		case ShapeType::Circle:
-			{
-				auto circle = static_cast<const Circle*>(shape.shape);
-				return std::make_pair(direction.normal() * circle->radius() + shape.transform.position, finalIndex);
-			}
+			return furthestPoint<Circle>(shape, direction, start);
 		case ShapeType::Ellipse:
-			{
-				auto ellipse = static_cast<const Ellipse*>(shape.shape);
-				target = GeometryAlgorithm2D::calculateEllipseProjectionPoint(ellipse->A(), ellipse->B(), rot_dir);
-				break;
-			}
+			return furthestPoint<Ellipse>(shape, direction, start);
 		case ShapeType::Edge:
-			{
-				auto edge = static_cast<const Edge*>(shape.shape);
-				const real dot1 = Vector2::dotProduct(edge->startPoint(), direction);
-				const real dot2 = Vector2::dotProduct(edge->endPoint(), direction);
-				target = dot1 > dot2 ? edge->startPoint() : edge->endPoint();
-				break;
-			}
+			return furthestPoint<Edge>(shape, direction, start);
 		case ShapeType::Capsule:
-			{
-				auto capsule = static_cast<const Capsule*>(shape.shape);
-				target = GeometryAlgorithm2D::calculateCapsuleProjectionPoint(
-					capsule->halfWidth(), capsule->halfHeight(), rot_dir);
-				finalIndex = 0;
-				const Vector2 test(Math::abs(target.x), Math::abs(target.y));
-				const Vector2 topRight = capsule->topRight();
-				if (test.equal(topRight))
-					finalIndex = 1;
-				break;
-			}
+			return furthestPoint<Capsule>(shape, direction, start);
 		}
-		rot.set(shape.transform.rotation);
-		target = rot.multiply(target);
-		target += shape.transform.position;
-		return std::make_pair(target, finalIndex);
+		return std::make_pair(Vector2(), UINT32_MAX);
 	}
 
 	Vector2 Narrowphase::findDirectionByEdge(const SimplexVertex& v1, const SimplexVertex& v2, bool pointToOrigin)
@@ -259,6 +592,85 @@ namespace Physics2D
 		return std::make_pair(target, index);
 	}
 
+	std::pair<Vector2, Index> Narrowphase::findFurthestPoint(const Polygon& polygon, const Vector2& direction,
+	                                                         Index start)
+	{
+		if (polygon.vertices().size() >= HillClimbingVertexCount && start < polygon.vertices().size())
+			return findFurthestPointByClimbing(polygon, direction, start);
+		return findFurthestPointByScan(polygon, direction);
+	}
+
+	std::pair<Vector2, Index> Narrowphase::findFurthestPointByScan(const Polygon& polygon, const Vector2& direction)
+	{
+		const auto& vertices = polygon.vertices();
+		const auto& laneX = polygon.laneX();
+		const auto& laneY = polygon.laneY();
+		if (laneX.empty())
+			return std::make_pair(Vector2(), 0);
+
+		//best dot product and its vertex index in every lane, indices are exact as floats
+		const Float4 dx = Float4::set(static_cast<float>(direction.x));
+		const Float4 dy = Float4::set(static_cast<float>(direction.y));
+		alignas(16) const float first[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+		Float4 index = Float4::load(first);
+		Float4 bestIndex = index;
+		Float4 best = laneX[0] * dx + laneY[0] * dy;
+		for (size_t block = 1; block < laneX.size(); ++block)
+		{
+			index = index + Float4::set(4.0f);
+			const Float4 dot = laneX[block] * dx + laneY[block] * dy;
+			//strictly further, so every lane keeps its lowest index on ties
+			const Float4 further = lessThan(best, dot);
+			best = select(further, dot, best);
+			bestIndex = select(further, index, bestIndex);
+		}
+
+		alignas(16) float dots[4];
+		alignas(16) float indices[4];
+		best.store(dots);
+		bestIndex.store(indices);
+		size_t lane = 0;
+		for (size_t i = 1; i < 4; ++i)
+		{
+			if (dots[i] > dots[lane] || (dots[i] == dots[lane] && indices[i] < indices[lane]))
+				lane = i;
+		}
+		const Index result = static_cast<Index>(indices[lane]);
+		return std::make_pair(vertices[result], result);
+	}
+
+	std::pair<Vector2, Index> Narrowphase::findFurthestPointByClimbing(const Polygon& polygon, const Vector2& direction,
+	                                                                   Index start)
+	{
+		//the dot products along a convex ring rise to the support vertex and fall behind it,
+		//so moving to the neighbor that lies further ends there
+		const auto& vertices = polygon.vertices();
+		const size_t count = vertices.size();
+		Index index = start;
+		real best = vertices[index].dot(direction);
+		const Index next = static_cast<Index>((index + 1) % count);
+		const Index prev = static_cast<Index>((index + count - 1) % count);
+		const real nextDot = vertices[next].dot(direction);
+		const real prevDot = vertices[prev].dot(direction);
+		//collinear vertices can leave the start on a flat stretch with no way up, scan instead
+		if (nextDot == best && prevDot == best)
+			return findFurthestPointByScan(polygon, direction);
+
+		const bool forward = nextDot > best;
+		if (!forward && prevDot <= best)
+			return std::make_pair(vertices[index], index);
+		for (size_t step = 1; step < count; ++step)
+		{
+			const Index candidate = static_cast<Index>(forward ? (index + 1) % count : (index + count - 1) % count);
+			const real dot = vertices[candidate].dot(direction);
+			if (dot <= best)
+				break;
+			best = dot;
+			index = candidate;
+		}
+		return std::make_pair(vertices[index], index);
+	}
+
 	ContactPair Narrowphase::generateContacts(const ShapePrimitive& shapeA,
 	                                          const ShapePrimitive& shapeB, CollisionInfo& info)
 	{
@@ -285,11 +697,6 @@ namespace Physics2D
 		//find feature
 		const Feature featureA = findFeatures(info.simplex, info.normal, realShapeA, idxA);
 		const Feature featureB = findFeatures(info.simplex, info.normal, realShapeB, idxB);
-		auto idA = std::pair{ featureA.index[0], featureA.index[1] };
-		pair.ids[0] = reinterpret_cast<uint64_t&>(idA);
-
-		auto idB = std::pair{ featureB.index[0], featureB.index[1] };
-		pair.ids[1] = reinterpret_cast<uint64_t&>(idB);
 
 		if (typeA == ShapeType::Polygon)
 		{
@@ -349,15 +756,89 @@ namespace Physics2D
 		{
 			std::swap(pair.points[0], pair.points[1]);
 			std::swap(pair.points[2], pair.points[3]);
-			std::swap(pair.ids[0], pair.ids[1]);
 			//restore normal
 			info.normal.negate();
 		}
+
+		//round shapes touch with a single point that keeps id 0
+		if (typeB == ShapeType::Circle || typeB == ShapeType::Ellipse)
+			return pair;
+
+		//the clip functions do not tell where their points came from, so the points of the touching features
+		//are told apart by their order along the contact tangent
+		auto featureId = [](const Feature& feature)
+		{
+			const Index first = feature.index[0] & 0x7FFF;
+			const Index second = feature.index[1] & 0x7FFF;
+			return static_cast<uint64_t>(std::min(first, second)) << 15 | static_cast<uint64_t>(std::max(first, second));
+		};
+		const uint64_t id = (isSwap ? featureId(featureB) << 30 | featureId(featureA)
+		                            : featureId(featureA) << 30 | featureId(featureB)) << 1;
+		pair.ids = {id, id | 1};
+		const Vector2 tangent = info.normal.perpendicular();
+		if (pair.count == 4 && tangent.dot(pair.points[2]) < tangent.dot(pair.points[0]))
+			std::swap(pair.ids[0], pair.ids[1]);
 		return pair;
 	}
 
+	template <typename ShapeA, typename ShapeB>
+	bool Narrowphase::collide(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, CollisionInfo& info,
+	                          ContactPair& contacts, CollisionCache* cache)
+	{
+		PairSupport<ShapeA, ShapeB> support;
+		Simplex simplex = gjkKernel(support, shapeA, shapeB, 30, cache);
+		bool isColliding = simplex.isContainOrigin;
+
+		if (shapeA.transform.position.fuzzyEqual(shapeB.transform.position) && !isColliding)
+			isColliding = simplex.containsOrigin(true);
+
+		if (!isColliding)
+			return false;
+
+		info = epaKernel(support, simplex, shapeA, shapeB, 30, Constant::GeometryEpsilon, false);
+		if (realEqual(info.penetration, 0))
+			return false;
+
+		contacts = generateContacts(shapeA, shapeB, info);
+		return true;
+	}
+
+	bool Narrowphase::collide(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB, CollisionInfo& info,
+	                          ContactPair& contacts, CollisionCache* cache)
+	{
+		return collide<Shape, Shape>(shapeA, shapeB, info, contacts, cache);
+	}
+
+	Narrowphase::CollideKernel Narrowphase::collideKernel(ShapeType typeA, ShapeType typeB)
+	{
+		//rows are shape A and columns are shape B, both in the order of ShapeType
+		static constexpr CollideKernel kernels[5][5] = {
+			{
+				&collide<Polygon, Polygon>, &collide<Polygon, Edge>, &collide<Polygon, Capsule>,
+				&collide<Polygon, Circle>, &collide<Polygon, Ellipse>
+			},
+			{
+				&collide<Edge, Polygon>, &collide<Edge, Edge>, &collide<Edge, Capsule>,
+				&collide<Edge, Circle>, &collide<Edge, Ellipse>
+			},
+			{
+				&collide<Capsule, Polygon>, &collide<Capsule, Edge>, &collide<Capsule, Capsule>,
+				&collide<Capsule, Circle>, &collide<Capsule, Ellipse>
+			},
+			{
+				&collide<Circle, Polygon>, &collide<Circle, Edge>, &collide<Circle, Capsule>,
+				&collide<Circle, Circle>, &collide<Circle, Ellipse>
+			},
+			{
+				&collide<Ellipse, Polygon>, &collide<Ellipse, Edge>, &collide<Ellipse, Capsule>,
+				&collide<Ellipse, Circle>, &collide<Ellipse, Ellipse>
+			}
+		};
+		return kernels[static_cast<size_t>(typeA)][static_cast<size_t>(typeB)];
+	}
+
 	CollisionInfo Narrowphase::gjkDistance(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-	                                       const size_t& iteration)
+	                                       const size_t& iteration, bool capturePolytope)
 	{
 		VertexPair result;
 		CollisionInfo info;
@@ -380,32 +861,26 @@ namespace Physics2D
 
 		reconstructSimplexByVoronoi(info.simplex);
 		info.originalSimplex = info.simplex;
-		//[DEBUG]
-		std::list<SimplexVertexWithOriginDistance>& polytope = info.polytope;
-		//std::list<SimplexVertexWithOriginDistance> polytope;
+		Polytope polytope;
+		polytope.build(info.simplex);
 
-		buildPolytopeFromSimplex(polytope, info.simplex);
-
-		auto iterStart = polytope.begin();
-		auto iterEnd = polytope.end();
-		auto iterTemp = polytope.begin();
+		size_t iterStart = 0;
+		size_t iterTemp = 0;
 
 		int errorCount = 0;
 
-		auto reindexSimplex = [&info, &polytope, &iterStart, &iterEnd, &iterTemp]
+		auto reindexSimplex = [&info, &polytope, &iterStart, &iterTemp]
 		{
 			std::swap(info.simplex.vertices[1], info.simplex.vertices[2]);
 			std::swap(info.simplex.vertices[0], info.simplex.vertices[1]);
-			polytope.clear();
-			buildPolytopeFromSimplex(polytope, info.simplex);
-			iterStart = polytope.begin();
-			iterEnd = polytope.end();
-			iterTemp = polytope.begin();
+			polytope.build(info.simplex);
+			iterStart = 0;
+			iterTemp = 0;
 		};
 
 		int sameDistCount = 0;
 
-		for (Index iter = 0; iter < iteration; ++iter)
+		for (Index iter = 0; iter < iteration && !polytope.full(); ++iter)
 		{
 			//indices of closest edge are set to 0 and 1
 			direction = findDirectionByEdge(info.simplex.vertices[0], info.simplex.vertices[1], true);
@@ -418,14 +893,11 @@ namespace Physics2D
 				if(sameDistCount == 1)
 				{
 					//check edge case
-					polytopeIterNext(iterStart, polytope);
-					iterEnd = iterStart;
-					polytopeIterPrev(iterEnd, polytope);
-					iterTemp = iterStart;
-					polytopeIterNext(iterTemp, polytope);
-
-					info.simplex.vertices[0] = iterStart->vertex;
-					info.simplex.vertices[1] = iterTemp->vertex;
+					iterStart = polytope.next(iterStart);
+					iterTemp = polytope.next(iterStart);
+
+					info.simplex.vertices[0] = polytope[iterStart].vertex;
+					info.simplex.vertices[1] = polytope[iterTemp].vertex;
 					iter--;
 					//do not process anymore
 					sameDistCount = -1;
@@ -447,20 +919,19 @@ namespace Physics2D
 			}
 			//convex test, make sure polytope is always convex
 
-			auto itA = iterStart;
-
-			auto itB = itA;
-			polytopeIterNext(itB, polytope);
-
-			auto itC = itB;
-			polytopeIterNext(itC, polytope);
+			const size_t itA = iterStart;
+			const size_t itB = polytope.next(itA);
+			const size_t itC = polytope.next(itB);
+			const Vector2& a = polytope[itA].vertex.result;
+			const Vector2& b = polytope[itB].vertex.result;
+			const Vector2& c = polytope[itC].vertex.result;
 
-			const Vector2 ab = itB->vertex.result - itA->vertex.result;
-			const Vector2 bc = itC->vertex.result - itB->vertex.result;
+			const Vector2 ab = b - a;
+			const Vector2 bc = c - b;
 			const real res1 = Vector2::crossProduct(ab, bc);
 
-			const Vector2 an = vertex.result - itA->vertex.result;
-			const Vector2 nb = itB->vertex.result - vertex.result;
+			const Vector2 an = vertex.result - a;
+			const Vector2 nb = b - vertex.result;
 			const real res2 = Vector2::crossProduct(an, nb);
 
 			const real res3 = Vector2::crossProduct(nb, bc);
@@ -486,12 +957,12 @@ namespace Physics2D
 
 			SimplexVertexWithOriginDistance pair;
 			pair.vertex = vertex;
-			const Vector2 t1 = GeometryAlgorithm2D::pointToLineSegment(itA->vertex.result, vertex.result, {0, 0});
+			const Vector2 t1 = GeometryAlgorithm2D::pointToLineSegment(a, vertex.result, {0, 0});
 			const real dist1 = t1.lengthSquare();
-			const Vector2 t2 = GeometryAlgorithm2D::pointToLineSegment(vertex.result, itB->vertex.result, {0, 0});
+			const Vector2 t2 = GeometryAlgorithm2D::pointToLineSegment(vertex.result, b, {0, 0});
 			const real dist2 = t2.lengthSquare();
 
-			itA->distance = dist1;
+			polytope[itA].distance = dist1;
 			pair.distance = dist2;
 			polytope.insert(itB, pair);
 			//TODO: if dist1 == dist2, and dist1 cannot be extended and dist2 can be extended.
@@ -502,33 +973,29 @@ namespace Physics2D
 
 			//find shortest distance and set iterStart
 			real minDistance = Constant::Max;
-			auto iterTarget = iterStart;
+			size_t iterTarget = iterStart;
 			while (true)
 			{
-				if (iterTemp->distance < minDistance)
+				if (polytope[iterTemp].distance < minDistance)
 				{
-					minDistance = iterTemp->distance;
+					minDistance = polytope[iterTemp].distance;
 					iterTarget = iterTemp;
 				}
-				polytopeIterNext(iterTemp, polytope);
+				iterTemp = polytope.next(iterTemp);
 				if (iterTemp == iterStart)
 					break;
 			}
 			iterStart = iterTarget;
-			iterEnd = iterTarget;
-			polytopeIterPrev(iterEnd, polytope);
 
 			//set to begin
-			iterTemp = iterStart;
-			polytopeIterNext(iterTemp, polytope);
+			iterTemp = polytope.next(iterStart);
 			//reset simplex
-			info.simplex.vertices[0] = iterStart->vertex;
-			info.simplex.vertices[1] = iterTemp->vertex;
+			info.simplex.vertices[0] = polytope[iterStart].vertex;
+			info.simplex.vertices[1] = polytope[iterTemp].vertex;
 			errorCount = 0;
 		}
-		auto idxStart = std::distance(polytope.begin(), iterStart);
-		polytopeIterNext(iterStart, polytope);
-		auto idxNext = std::distance(polytope.begin(), iterStart);
+		if (capturePolytope)
+			capture(polytope, info);
 		info.simplex.removeEnd();
 		//Convex combination for calculating distance points
 		//https://dyn4j.org/2010/04/gjk-distance-closest-points/
@@ -565,6 +1032,99 @@ namespace Physics2D
 		return info;
 	}
 
+	bool GjkBatch::add(const ShapePrimitive& shapeA, const ShapePrimitive& shapeB)
+	{
+		assert(size < LaneCount);
+		Vector2 coreA[MaxVertices];
+		Vector2 coreB[MaxVertices];
+		size_t vertexCountA = 0;
+		size_t vertexCountB = 0;
+		real radiusA = 0;
+		real radiusB = 0;
+		if (!batchCore(shapeA, coreA, vertexCountA, radiusA) || !batchCore(shapeB, coreB, vertexCountB, radiusB))
+			return false;
+
+		for (size_t i = 0; i < MaxVertices; ++i)
+		{
+			const Vector2& vertexA = coreA[std::min(i, vertexCountA - 1)];
+			const Vector2& vertexB = coreB[std::min(i, vertexCountB - 1)];
+			ax[i][size] = static_cast<float>(vertexA.x);
+			ay[i][size] = static_cast<float>(vertexA.y);
+			bx[i][size] = static_cast<float>(vertexB.x);
+			by[i][size] = static_cast<float>(vertexB.y);
+		}
+		radius[size] = static_cast<float>(radiusA + radiusB);
+		countA = std::max(countA, vertexCountA);
+		countB = std::max(countB, vertexCountB);
+		++size;
+		return true;
+	}
+
+	void GjkBatch::clear()
+	{
+		countA = 0;
+		countB = 0;
+		size = 0;
+	}
+
+	void Narrowphase::gjkSeparated(const GjkBatch& batch, bool* separated, const size_t& iteration)
+	{
+		const Float4 zero = Float4::set(0.0f);
+		//lanes without a pair start finished
+		alignas(16) float used[GjkBatch::LaneCount];
+		for (size_t i = 0; i < GjkBatch::LaneCount; ++i)
+			used[i] = i < batch.size ? 1.0f : 0.0f;
+		Float4 active = lessThan(zero, Float4::load(used));
+		Float4 apart = zero;
+		const Float4 reach = Float4::load(batch.radius) + Float4::set(BatchSeparationMargin);
+		const Float4 reachSquare = reach * reach;
+
+		LaneSimplex simplex;
+		simplex.x[0] = Float4::load(batch.ax[0]) - Float4::load(batch.bx[0]);
+		simplex.y[0] = Float4::load(batch.ay[0]) - Float4::load(batch.by[0]);
+		simplex.x[1] = simplex.x[2] = zero;
+		simplex.y[1] = simplex.y[2] = zero;
+		simplex.count = Float4::set(1.0f);
+		simplex.vx = simplex.x[0];
+		simplex.vy = simplex.y[0];
+
+		for (size_t i = 0; i < iteration && bits(active) != 0; ++i)
+		{
+			//support of A - B furthest along -v
+			Float4 pax, pay, pbx, pby;
+			laneSupport(batch.ax, batch.ay, batch.countA, -simplex.vx, -simplex.vy, pax, pay);
+			laneSupport(batch.bx, batch.by, batch.countB, simplex.vx, simplex.vy, pbx, pby);
+			const Float4 wx = pax - pbx;
+			const Float4 wy = pay - pby;
+
+			//no point of A - B is closer to the origin than vw / |v|, the lane is apart once that exceeds its reach
+			const Float4 vv = simplex.vx * simplex.vx + simplex.vy * simplex.vy;
+			const Float4 vw = simplex.vx * wx + simplex.vy * wy;
+			const Float4 proven = active & lessThan(zero, vw) & lessThan(reachSquare * vv, vw * vw);
+			apart = apart | proven;
+			active = andNot(proven, active);
+			//v does not get any closer or reached the origin, the lane is too close to decide here
+			active = andNot(lessEqual(vv - vw, Float4::set(BatchConvergence) * vv), active);
+
+			//w becomes the last vertex of the simplex, which has one or two vertices in an active lane
+			const Float4 one = active & lessThan(simplex.count, Float4::set(1.5f));
+			const Float4 two = andNot(one, active);
+			simplex.x[1] = select(one, wx, simplex.x[1]);
+			simplex.y[1] = select(one, wy, simplex.y[1]);
+			simplex.x[2] = select(two, wx, simplex.x[2]);
+			simplex.y[2] = select(two, wy, simplex.y[2]);
+			simplex.count = select(active, simplex.count + Float4::set(1.0f), simplex.count);
+
+			Float4 enclosed;
+			solveLanes(simplex, active, enclosed);
+			active = andNot(enclosed, active);
+		}
+
+		const int mask = bits(apart);
+		for (size_t i = 0; i < batch.size; ++i)
+			separated[i] = (mask >> i & 1) != 0;
+	}
+
 	void Narrowphase::reconstructSimplexByVoronoi(Simplex& simplex)
 	{
 		//use barycentric coordinates to check contains origin and find closest edge
@@ -581,6 +1141,15 @@ namespace Physics2D
 		const real ac_length = ac.length();
 		const real bc_length = bc.length();
 
+		//a support point was repeated and the simplex is a segment, its two distinct points are kept first as
+		//the closest edge
+		if (ab_length == 0.0f || ac_length == 0.0f || bc_length == 0.0f)
+		{
+			if (ab_length == 0.0f)
+				std::swap(simplex.vertices[1], simplex.vertices[2]);
+			return;
+		}
+
 		const real u_ac = -a.dot(ac.normal()) / ac_length;
 		const real u_bc = -b.dot(bc.normal()) / bc_length;
 
@@ -622,24 +1191,27 @@ namespace Physics2D
 		}
 	}
 
-	bool Narrowphase::perturbSimplex(Simplex& simplex, const ShapePrimitive& shapeA, const ShapePrimitive& shapeB,
-	                                 const Vector2& dir)
+	template <typename Support>
+	bool Narrowphase::perturbSimplex(Support& support, Simplex& simplex, const ShapePrimitive& shapeA,
+	                                 const ShapePrimitive& shapeB, const Vector2& dir)
 	{
 		Vector2 direction = dir;
 		for (int i = 0; i < Constant::GJKRetryTimes; ++i)
 		{
 			direction.set(-direction.y + static_cast<real>(i), -direction.x - static_cast<real>(i));
-			SimplexVertex v = support(shapeA, shapeB, direction);
+			SimplexVertex v = support.support(shapeA, shapeB, direction);
 			simplex.vertices[0] = v;
 			direction.set(-direction.y - static_cast<real>(i) - 0.5f, -direction.x + static_cast<real>(i) + 0.5f);
-			v = support(shapeA, shapeB, direction);
+			v = support.support(shapeA, shapeB, direction);
 			simplex.vertices[1] = v;
 
 			if (!simplex.containsOrigin())
 				return true;
 		}
 		//can't reconstruct
+#if defined(_MSC_VER)
 		__debugbreak();
+#endif
 		return true;
 	}
 
@@ -786,7 +1358,8 @@ namespace Physics2D
 		incEdge[0].isFinalValid = (incEdge[0].vertex - refEdge[0]).dot(refEdgeNormal) >= 0;
 		incEdge[1].isFinalValid = (incEdge[1].vertex - refEdge[0]).dot(refEdgeNormal) >= 0;
 
-		assert(incEdge[0].isFinalValid || incEdge[1].isFinalValid && "Invalid features.");
+		if (!incEdge[0].isFinalValid && !incEdge[1].isFinalValid)
+			return pair;
 
 		if (incEdge[0].isFinalValid && !incEdge[1].isFinalValid)
 		{
@@ -1243,35 +1816,80 @@ namespace Physics2D
 		return pair;
 	}
 
-	void Narrowphase::polytopeIterNext(std::list<SimplexVertexWithOriginDistance>::iterator& targetIter,
-	                                   std::list<SimplexVertexWithOriginDistance>& list)
-	{
-		++targetIter;
-		if (targetIter == list.end())
-			targetIter = list.begin();
-	}
-
-	void Narrowphase::polytopeIterPrev(std::list<SimplexVertexWithOriginDistance>::iterator& targetIter,
-	                                   std::list<SimplexVertexWithOriginDistance>& list)
+	void Narrowphase::capture(const Polytope& polytope, CollisionInfo& info)
 	{
-		if (targetIter == list.begin())
-			targetIter = list.end();
-		--targetIter;
+		info.polytope.clear();
+		for (size_t i = 0; i < polytope.size(); ++i)
+			info.polytope.emplace_back(polytope[i]);
 	}
 
-	void Narrowphase::buildPolytopeFromSimplex(std::list<SimplexVertexWithOriginDistance>& polytope,
-	                                           const Simplex& simplex)
+	void Polytope::build(const Simplex& simplex)
 	{
-		for (auto iter = simplex.vertices.begin(); iter != simplex.vertices.end(); ++iter)
+		m_count = 0;
+		for (size_t i = 0; i < simplex.vertices.size(); ++i)
 		{
-			auto next = iter + 1;
-			if (next == simplex.vertices.end())
-				next = simplex.vertices.begin();
-			SimplexVertexWithOriginDistance pair;
-			pair.vertex = *iter;
-			pair.distance = GeometryAlgorithm2D::pointToLineSegment(iter->result, next->result, {0, 0})
+			const SimplexVertex& vertex = simplex.vertices[i];
+			const SimplexVertex& next = simplex.vertices[(i + 1) % simplex.vertices.size()];
+			SimplexVertexWithOriginDistance elem;
+			elem.vertex = vertex;
+			elem.distance = GeometryAlgorithm2D::pointToLineSegment(vertex.result, next.result, {0, 0})
 				.lengthSquare(); //use lengthSquare() to avoid sqrt
-			polytope.emplace_back(pair);
+			new (slots() + m_count++) SimplexVertexWithOriginDistance(elem);
 		}
 	}
+
+	size_t Polytope::next(size_t index) const
+	{
+		return index + 1 == m_count ? 0 : index + 1;
+	}
+
+	size_t Polytope::prev(size_t index) const
+	{
+		return index == 0 ? m_count - 1 : index - 1;
+	}
+
+	void Polytope::insert(size_t index, const SimplexVertexWithOriginDistance& vertex)
+	{
+		assert(!full());
+		//inserting before the first vertex is the same as appending in a ring
+		if (index == 0)
+			index = m_count;
+		//the slot past the end is raw storage, the vertices are trivially destructible so it is simply constructed over
+		for (size_t i = m_count; i > index; --i)
+			new (slots() + i) SimplexVertexWithOriginDistance(slots()[i - 1]);
+		new (slots() + index) SimplexVertexWithOriginDistance(vertex);
+		++m_count;
+	}
+
+	bool Polytope::full() const
+	{
+		return m_count == Capacity;
+	}
+
+	size_t Polytope::size() const
+	{
+		return m_count;
+	}
+
+	SimplexVertexWithOriginDistance& Polytope::operator[](size_t index)
+	{
+		assert(index < m_count);
+		return slots()[index];
+	}
+
+	const SimplexVertexWithOriginDistance& Polytope::operator[](size_t index) const
+	{
+		assert(index < m_count);
+		return slots()[index];
+	}
+
+	SimplexVertexWithOriginDistance* Polytope::slots()
+	{
+		return std::launder(reinterpret_cast<SimplexVertexWithOriginDistance*>(m_storage));
+	}
+
+	const SimplexVertexWithOriginDistance* Polytope::slots() const
+	{
+		return std::launder(reinterpret_cast<const SimplexVertexWithOriginDistance*>(m_storage));
+	}
 }
@@ -13,6 +13,21 @@ namespace Physics2D
 		return m_vertices;
 	}
 
+	const Container::Vector<Vector2>& Polygon::normals() const
+	{
+		return m_normals;
+	}
+
+	const Container::Vector<Float4>& Polygon::laneX() const
+	{
+		return m_laneX;
+	}
+
+	const Container::Vector<Float4>& Polygon::laneY() const
+	{
+		return m_laneY;
+	}
+
 	void Polygon::append(const std::initializer_list<Vector2>& vertices)
 	{
 		for (const Vector2& vertex : vertices)
@@ -36,6 +51,7 @@ namespace Physics2D
 		assert(!m_vertices.empty());
 		for (Vector2& vertex : m_vertices)
 			vertex *= factor;
+		updateLanes();
 	}
 
 	bool Polygon::contains(const Vector2& point, const real& epsilon)
@@ -60,5 +76,55 @@ namespace Physics2D
 		Vector2 center = this->center();
 		for (auto& elem : m_vertices)
 			elem -= center;
+		updateNormals();
+		updateLanes();
+	}
+
+	void Polygon::updateNormals()
+	{
+		//no edges to speak of while the polygon is still being appended
+		if (m_vertices.size() < 3)
+		{
+			m_normals.clear();
+			return;
+		}
+		m_normals.resize(m_vertices.size());
+		for (size_t i = 0; i < m_vertices.size(); ++i)
+		{
+			const Vector2& current = m_vertices[i];
+			const Vector2& next = m_vertices[(i + 1) % m_vertices.size()];
+			const Vector2 edge = next - current;
+			//an empty shape, like a rectangle before it is set, has no edge to face
+			if (edge.lengthSquare() < Constant::Epsilon)
+			{
+				m_normals[i].clear();
+				continue;
+			}
+			Vector2 normal = edge.perpendicular().normal();
+			//vertices are centered, so the outward side is the one facing away from the origin
+			if (normal.dot(current) < 0)
+				normal.negate();
+			m_normals[i] = normal;
+		}
+	}
+
+	void Polygon::updateLanes()
+	{
+		const size_t blocks = (m_vertices.size() + 3) / 4;
+		m_laneX.resize(blocks);
+		m_laneY.resize(blocks);
+		for (size_t block = 0; block < blocks; ++block)
+		{
+			alignas(16) float x[4];
+			alignas(16) float y[4];
+			for (size_t lane = 0; lane < 4; ++lane)
+			{
+				const Vector2& vertex = m_vertices[std::min(block * 4 + lane, m_vertices.size() - 1)];
+				x[lane] = static_cast<float>(vertex.x);
+				y[lane] = static_cast<float>(vertex.y);
+			}
+			m_laneX[block] = Float4::load(x);
+			m_laneY[block] = Float4::load(y);
+		}
 	}
 }
\ No newline at end of file
@@ -65,15 +65,176 @@ namespace Physics2D
 		generate(m_rootIndex, pairs);
 		return pairs;
 	}
+
+	const Container::Vector<std::pair<Body*, Body*>>& Tree::updatePairs(const real& sweep)
+	{
+		m_beginPairs.clear();
+		m_endPairs.clear();
+
+		//the boxes every pair was tested with are swept by the old time
+		if (sweep != m_sweep)
+		{
+			m_sweep = sweep;
+			for (auto&& [body, proxy] : m_proxies)
+				m_touchBuffer.emplace_back(&proxy);
+		}
+
+		//in id order, so that the pairs are reported in the same order on every run
+		std::sort(m_moveBuffer.begin(), m_moveBuffer.end(), [](Body* a, Body* b)
+		{
+			return a->id() < b->id();
+		});
+		m_moveBuffer.erase(std::unique(m_moveBuffer.begin(), m_moveBuffer.end()), m_moveBuffer.end());
+		for (Body* body : m_moveBuffer)
+			m_touchBuffer.emplace_back(&m_proxies[body]);
+		std::sort(m_touchBuffer.begin(), m_touchBuffer.end(), [](Proxy* a, Proxy* b)
+		{
+			return a->body->id() < b->body->id();
+		});
+		m_touchBuffer.erase(std::unique(m_touchBuffer.begin(), m_touchBuffer.end()), m_touchBuffer.end());
+
+		for (Proxy* proxy : m_touchBuffer)
+		{
+			Body* body = proxy->body;
+			AABB& swept = proxy->swept;
+			swept = AABB::fromBody(body);
+			if (sweep > 0 && !body->velocity().isOrigin())
+			{
+				AABB moved = swept;
+				moved.position += body->velocity() * sweep;
+				swept.unite(moved);
+			}
+		}
+
+		//fat AABBs of bodies that did not move are unchanged, so only pairs with a mover can stop overlapping
+		for (Body* body : m_moveBuffer)
+		{
+			const AABB& fat = m_tree[m_bodyTable[body]].aabb;
+			auto& pairs = m_proxies[body].pairs;
+			for (size_t i = 0; i < pairs.size();)
+			{
+				CachedPair* pair = pairs[i];
+				Body* other = pair->bodies.first == body ? pair->bodies.second : pair->bodies.first;
+				if (fat.collide(m_tree[m_bodyTable[other]].aabb))
+				{
+					++i;
+					continue;
+				}
+				m_endPairs.emplace_back(pair->bodies);
+				//takes the pair out of this list too, the last one moves into its place
+				erase(pair);
+			}
+		}
+
+		Container::Vector<Body*> overlaps;
+		for (Body* body : m_moveBuffer)
+		{
+			overlaps.clear();
+			queryNodes(m_rootIndex, m_tree[m_bodyTable[body]].aabb, overlaps);
+			for (Body* other : overlaps)
+			{
+				if (other == body)
+					continue;
+				auto [iter, inserted] = m_pairTable.try_emplace(Body::BodyPair::generateBodyPairID(body, other));
+				if (!inserted)
+					continue;
+				CachedPair& pair = iter->second;
+				pair.bodies = body->id() < other->id() ? std::pair{ body, other } : std::pair{ other, body };
+				pair.proxies[0] = &m_proxies[pair.bodies.first];
+				pair.proxies[1] = &m_proxies[pair.bodies.second];
+				pair.proxies[0]->pairs.emplace_back(&pair);
+				pair.proxies[1]->pairs.emplace_back(&pair);
+				m_beginPairs.emplace_back(pair.bodies);
+			}
+		}
+		m_moveBuffer.clear();
+
+		//the cache is coarse, report only pairs that generate would report. the others kept their boxes
+		for (Proxy* proxy : m_touchBuffer)
+		{
+			for (CachedPair* pair : proxy->pairs)
+			{
+				auto [bodyA, bodyB] = pair->bodies;
+				report(pair, (bodyA->bitmask() & bodyB->bitmask()) &&
+				             pair->proxies[0]->swept.collide(pair->proxies[1]->swept));
+			}
+		}
+		m_touchBuffer.clear();
+		return m_pairs;
+	}
+
+	void Tree::erase(CachedPair* pair)
+	{
+		report(pair, false);
+		for (Proxy* proxy : pair->proxies)
+		{
+			auto iter = std::find(proxy->pairs.begin(), proxy->pairs.end(), pair);
+			*iter = proxy->pairs.back();
+			proxy->pairs.pop_back();
+		}
+		m_pairTable.erase(Body::BodyPair::generateBodyPairID(pair->bodies.first, pair->bodies.second));
+	}
+
+	void Tree::report(CachedPair* pair, bool overlap)
+	{
+		if (overlap == (pair->slot != SIZE_MAX))
+			return;
+		if (overlap)
+		{
+			pair->slot = m_pairs.size();
+			m_pairs.emplace_back(pair->bodies);
+			m_pairCaches.emplace_back(&pair->cache);
+			m_pairOwners.emplace_back(pair);
+			return;
+		}
+		//the last reported pair takes the slot
+		CachedPair* last = m_pairOwners.back();
+		m_pairs[pair->slot] = m_pairs.back();
+		m_pairCaches[pair->slot] = m_pairCaches.back();
+		m_pairOwners[pair->slot] = last;
+		last->slot = pair->slot;
+		m_pairs.pop_back();
+		m_pairCaches.pop_back();
+		m_pairOwners.pop_back();
+		pair->slot = SIZE_MAX;
+	}
+
+	const Container::Vector<CollisionCache*>& Tree::pairCaches() const
+	{
+		return m_pairCaches;
+	}
+
+	const Container::Vector<std::pair<Body*, Body*>>& Tree::beginPairs() const
+	{
+		return m_beginPairs;
+	}
+
+	const Container::Vector<std::pair<Body*, Body*>>& Tree::endPairs() const
+	{
+		return m_endPairs;
+	}
+
+	size_t Tree::cachedPairCount() const
+	{
+		return m_pairTable.size();
+	}
 	
 
 	void Tree::insert(Body* body)
+	{
+		AABB fat = AABB::fromBody(body);
+		fat.expand(m_fatExpansionFactor);
+		insert(body, fat);
+	}
+
+	void Tree::insert(Body* body, const AABB& fat)
 	{
 		int newNodeIndex = allocateNode();
 		m_tree[newNodeIndex].body = body;
-		m_tree[newNodeIndex].aabb = AABB::fromBody(body);
-		m_tree[newNodeIndex].aabb.expand(m_fatExpansionFactor);
+		m_tree[newNodeIndex].aabb = fat;
 		m_bodyTable[body] = newNodeIndex;
+		m_proxies[body].body = body;
+		m_moveBuffer.emplace_back(body);
 		if(m_rootIndex == -1)
 		{
 			m_rootIndex = newNodeIndex;
@@ -108,6 +269,15 @@ namespace Physics2D
 		auto iter = m_bodyTable.find(body);
 		if (iter == m_bodyTable.end())
 			return;
+
+		//the body is gone, drop its pairs without reporting them
+		std::erase(m_moveBuffer, body);
+		auto proxy = m_proxies.find(body);
+		std::erase(m_touchBuffer, &proxy->second);
+		while (!proxy->second.pairs.empty())
+			erase(proxy->second.pairs.back());
+		m_proxies.erase(proxy);
+
 		int parentIndex = m_tree[iter->second].parentIndex;
 
 		if (parentIndex == -1 && m_tree[iter->second].isLeaf())
@@ -131,20 +301,49 @@ namespace Physics2D
 		m_emptyList.clear();
 		m_bodyTable.clear();
 		m_rootIndex = -1;
+		m_moveBuffer.clear();
+		m_touchBuffer.clear();
+		m_proxies.clear();
+		m_pairTable.clear();
+		m_pairs.clear();
+		m_pairCaches.clear();
+		m_pairOwners.clear();
+		m_beginPairs.clear();
+		m_endPairs.clear();
 	}
 
 	void Tree::update(Body* body)
+	{
+		update(body, Vector2());
+	}
+
+	void Tree::update(Body* body, const Vector2& displacement)
 	{
 		auto iter = m_bodyTable.find(body);
 		if (iter == m_bodyTable.end())
 			return;
 
-		AABB thin = AABB::fromBody(body);
+		AABB swept = AABB::fromBody(body);
+		//pairs of bodies that are at rest keep the result of their last test
+		Proxy& proxy = m_proxies[body];
+		if (!(swept == proxy.tight) || (body->type() != Body::BodyType::Static && !body->sleep()))
+		{
+			proxy.tight = swept;
+			m_touchBuffer.emplace_back(&proxy);
+		}
+		if (!displacement.isOrigin())
+		{
+			AABB moved = swept;
+			moved.position += displacement;
+			swept.unite(moved);
+		}
+		AABB thin = swept;
 		thin.expand(0.1f);
 		if (!thin.isSubset(m_tree[iter->second].aabb))
 		{
 			extract(iter->second);
-			insert(body);
+			swept.expand(m_fatExpansionFactor);
+			insert(body, swept);
 		}
 	}
 
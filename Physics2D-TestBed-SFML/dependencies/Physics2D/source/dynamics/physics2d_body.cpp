@@ -1,50 +1,75 @@
 #include "physics2d_body.h"
 namespace Physics2D {
 
+    Body::Body() : m_localStore(std::make_unique<BodyStore>())
+    {
+        m_store = m_localStore.get();
+        m_index = m_store->add(this);
+    }
+
+    Body::Body(BodyStore* store) : m_store(store)
+    {
+        assert(store != nullptr);
+        m_index = m_store->add(this);
+    }
+
+    Body::~Body() = default;
+
     Vector2& Body::position()
     {
-        return m_position;
+        return m_store->position[m_index];
     }
     
 
     Vector2& Body::velocity() 
     {
-        return m_velocity;
+        return m_store->velocity[m_index];
     }
     
 
     real& Body::rotation() 
     {
-        return m_rotation;
+        return m_store->rotation[m_index];
+    }
+
+    const Matrix2x2& Body::rotationMatrix() const
+    {
+        const real rotation = m_store->rotation[m_index];
+        if (m_store->matrixRotation[m_index] != rotation)
+        {
+            m_store->rotationMatrix[m_index].set(rotation);
+            m_store->matrixRotation[m_index] = rotation;
+        }
+        return m_store->rotationMatrix[m_index];
     }
 
     real& Body::angularVelocity()
     {
-        return m_angularVelocity;
+        return m_store->angularVelocity[m_index];
     }
 
     Vector2& Body::forces()
     {
-        return m_forces;
+        return m_store->forces[m_index];
     }
     
 	
 	void Body::clearTorque()
     {
-        m_torques = 0;
+        m_store->torques[m_index] = 0;
     }
 	
     real& Body::torques()
     {
-        return m_torques;
+        return m_store->torques[m_index];
     }
     Vector2& Body::lastPosition()
     {
-        return m_lastPosition;
+        return m_store->lastPosition[m_index];
     }
     real& Body::lastRotation()
     {
-        return m_lastRotation;
+        return m_store->lastRotation[m_index];
     }
     uint32_t& Body::sleepCountdown()
     {
@@ -58,17 +83,19 @@ namespace Physics2D {
     void Body::setShape(Shape* shape)
     {
         m_shape = shape;
+        m_aabbRotation = std::numeric_limits<real>::quiet_NaN();
+        ++m_store->transformStamp[m_index];
         calcInertia();
     }
 
     Body::BodyType Body::type() const
     {
-        return m_type;
+        return m_store->type[m_index];
     }
 
     void Body::setType(const Body::BodyType &type)
     {
-        m_type = type;
+        m_store->type[m_index] = type;
     }
 
     real Body::mass() const
@@ -81,9 +108,9 @@ namespace Physics2D {
         m_mass = mass;
     	
     	if(realEqual(mass,Constant::Max))
-            m_invMass = 0;
+            m_store->inverseMass[m_index] = 0;
         else
-			m_invMass = !realEqual(mass, 0) ? 1.0f / mass : 0;
+			m_store->inverseMass[m_index] = !realEqual(mass, 0) ? 1.0f / mass : 0;
     	
         calcInertia();
     }
@@ -95,11 +122,21 @@ namespace Physics2D {
 
     AABB Body::aabb(const real &factor) const
     {
-        ShapePrimitive primitive;
-        primitive.transform.position = m_position;
-        primitive.transform.rotation = m_rotation;
-        primitive.shape = m_shape;
-        return AABB::fromShape(primitive, factor);
+        const Vector2& position = m_store->position[m_index];
+        const real rotation = m_store->rotation[m_index];
+        if (m_aabbRotation != rotation || m_aabbPosition.x != position.x || m_aabbPosition.y != position.y)
+        {
+            ShapePrimitive primitive;
+            primitive.transform.position = position;
+            primitive.transform.setRotation(rotation, rotationMatrix());
+            primitive.shape = m_shape;
+            m_aabb = AABB::fromShape(primitive, 0.0f);
+            m_aabbPosition = position;
+            m_aabbRotation = rotation;
+        }
+        AABB result = m_aabb;
+        result.expand(factor);
+        return result;
     }
 
     real Body::friction() const
@@ -114,60 +151,77 @@ namespace Physics2D {
 
     bool Body::sleep() const
     {
-        return m_sleep;
+        return m_store->sleep[m_index] != 0;
     }
 
     void Body::setSleep(bool sleep)
     {
-        m_sleep = sleep;
+        m_store->sleep[m_index] = sleep ? 1 : 0;
+        //a woken body has to stay still for a full countdown again before its island may sleep
+        if (!sleep)
+            m_sleepCountdown = 0;
     }
 
     real Body::inverseMass() const
     {
-        return m_invMass;
+        return m_store->inverseMass[m_index];
     }
 
     real Body::inverseInertia() const
     {
-        return m_invInertia;
+        return m_store->inverseInertia[m_index];
     }
 
     Body::PhysicsAttribute Body::physicsAttribute() const
     {
-        return {m_position, m_velocity, m_rotation, m_angularVelocity};
+        return {m_store->position[m_index], m_store->velocity[m_index], m_store->rotation[m_index], m_store->angularVelocity[m_index]};
     }
 
     void Body::setPhysicsAttribute(const PhysicsAttribute& info)
     {
-        m_position = info.position;
-        m_rotation = info.rotation;
-        m_velocity = info.velocity;
-        m_angularVelocity = info.angularVelocity;
+        m_store->position[m_index] = info.position;
+        m_store->rotation[m_index] = info.rotation;
+        m_store->velocity[m_index] = info.velocity;
+        m_store->angularVelocity[m_index] = info.angularVelocity;
     }
 
     void Body::stepPosition(const real& dt)
     {
-        m_position += m_velocity * dt;
-        m_rotation += m_angularVelocity * dt;
+        m_store->position[m_index] += m_store->velocity[m_index] * dt;
+        m_store->rotation[m_index] += m_store->angularVelocity[m_index] * dt;
     }
 
     void Body::applyImpulse(const Vector2& impulse, const Vector2& r)
     {
-        m_velocity += m_invMass * impulse;
-        m_angularVelocity += m_invInertia * r.cross(impulse);
+        //immovable bodies are shared between islands that may be solved on different threads, never write them
+        if (m_store->inverseMass[m_index] == 0.0f && m_store->inverseInertia[m_index] == 0.0f)
+            return;
+        m_store->velocity[m_index] += m_store->inverseMass[m_index] * impulse;
+        m_store->angularVelocity[m_index] += m_store->inverseInertia[m_index] * r.cross(impulse);
+    }
+
+    void Body::applyPositionImpulse(const Vector2& impulse, const Vector2& r)
+    {
+        if (m_store->inverseMass[m_index] == 0.0f && m_store->inverseInertia[m_index] == 0.0f)
+            return;
+        m_store->position[m_index] += m_store->inverseMass[m_index] * impulse;
+        m_store->rotation[m_index] += m_store->inverseInertia[m_index] * r.cross(impulse);
     }
     Vector2 Body::toLocalPoint(const Vector2& point)const
     {
-        return Matrix2x2(-m_rotation).multiply(point - m_position);
+        //the inverse of a rotation matrix is its transpose
+        const Matrix2x2& matrix = rotationMatrix();
+        const Vector2 relative = point - m_store->position[m_index];
+        return Vector2(matrix.column1.dot(relative), matrix.column2.dot(relative));
     }
 
     Vector2 Body::toWorldPoint(const Vector2& point) const
     {
-        return Matrix2x2(m_rotation).multiply(point) + m_position;
+        return rotationMatrix().multiply(point) + m_store->position[m_index];
     }
     Vector2 Body::toActualPoint(const Vector2& point) const
     {
-        return Matrix2x2(m_rotation).multiply(point);
+        return rotationMatrix().multiply(point);
     }
 
     uint32_t Body::id() const
@@ -202,8 +256,12 @@ namespace Physics2D {
 
     real Body::kineticEnergy() const
     {
-        const real energyByPos = 0.5f * m_mass * (m_position - m_lastPosition).lengthSquare() + 0.5f * m_inertia * std::pow(m_rotation - m_lastRotation, 2);
-        const real energyByVel = 0.5f * m_mass * m_velocity.lengthSquare() + 0.5f * m_inertia * m_angularVelocity * m_angularVelocity;
+        const Vector2& position = m_store->position[m_index];
+        const Vector2& velocity = m_store->velocity[m_index];
+        const real rotation = m_store->rotation[m_index];
+        const real angularVelocity = m_store->angularVelocity[m_index];
+        const real energyByPos = 0.5f * m_mass * (position - m_store->lastPosition[m_index]).lengthSquare() + 0.5f * m_inertia * std::pow(rotation - m_store->lastRotation[m_index], 2);
+        const real energyByVel = 0.5f * m_mass * velocity.lengthSquare() + 0.5f * m_inertia * angularVelocity * angularVelocity;
         const real mixEnergy = 0.5f * (energyByPos + energyByVel);
         return mixEnergy;
     }
@@ -281,9 +339,19 @@ namespace Physics2D {
             break;
         }
         if (realEqual(m_mass, Constant::Max))
-            m_invInertia = 0;
+            m_store->inverseInertia[m_index] = 0;
         else
-			m_invInertia = !realEqual(m_inertia, 0) ? 1.0f / m_inertia : 0;
+			m_store->inverseInertia[m_index] = !realEqual(m_inertia, 0) ? 1.0f / m_inertia : 0;
+    }
+
+    Index Body::storeIndex() const
+    {
+        return m_index;
+    }
+
+    uint32_t Body::transformStamp() const
+    {
+        return m_store->transformStamp[m_index];
     }
 
     Body::BodyPair::BodyPairID Body::BodyPair::generateBodyPairID(Body* bodyA, Body* bodyB)
@@ -318,6 +386,127 @@ namespace Physics2D {
 
 
 
+    Index BodyStore::add(Body* owner)
+    {
+        const Index index = static_cast<Index>(body.size());
+        position.emplace_back();
+        velocity.emplace_back();
+        rotation.emplace_back(0.0f);
+        rotationMatrix.emplace_back(0.0f);
+        matrixRotation.emplace_back(0.0f);
+        angularVelocity.emplace_back(0.0f);
+        forces.emplace_back();
+        torques.emplace_back(0.0f);
+        inverseMass.emplace_back(0.0f);
+        inverseInertia.emplace_back(0.0f);
+        lastPosition.emplace_back();
+        lastRotation.emplace_back(0.0f);
+        type.emplace_back(Body::BodyType::Static);
+        sleep.emplace_back(0);
+        stampPosition.emplace_back();
+        stampRotation.emplace_back(0.0f);
+        transformStamp.emplace_back(0);
+        body.emplace_back(owner);
+        return index;
+    }
+
+    void BodyStore::remove(const Index& index)
+    {
+        assert(index < body.size());
+        const Index last = static_cast<Index>(body.size() - 1);
+        if (index != last)
+        {
+            position[index] = position[last];
+            velocity[index] = velocity[last];
+            rotation[index] = rotation[last];
+            rotationMatrix[index] = rotationMatrix[last];
+            matrixRotation[index] = matrixRotation[last];
+            angularVelocity[index] = angularVelocity[last];
+            forces[index] = forces[last];
+            torques[index] = torques[last];
+            inverseMass[index] = inverseMass[last];
+            inverseInertia[index] = inverseInertia[last];
+            lastPosition[index] = lastPosition[last];
+            lastRotation[index] = lastRotation[last];
+            type[index] = type[last];
+            sleep[index] = sleep[last];
+            stampPosition[index] = stampPosition[last];
+            stampRotation[index] = stampRotation[last];
+            transformStamp[index] = transformStamp[last];
+            body[index] = body[last];
+            body[index]->m_index = index;
+        }
+        position.pop_back();
+        velocity.pop_back();
+        rotation.pop_back();
+        rotationMatrix.pop_back();
+        matrixRotation.pop_back();
+        angularVelocity.pop_back();
+        forces.pop_back();
+        torques.pop_back();
+        inverseMass.pop_back();
+        inverseInertia.pop_back();
+        lastPosition.pop_back();
+        lastRotation.pop_back();
+        type.pop_back();
+        sleep.pop_back();
+        stampPosition.pop_back();
+        stampRotation.pop_back();
+        transformStamp.pop_back();
+        body.pop_back();
+    }
+
+    void BodyStore::clear()
+    {
+        position.clear();
+        velocity.clear();
+        rotation.clear();
+        rotationMatrix.clear();
+        matrixRotation.clear();
+        angularVelocity.clear();
+        forces.clear();
+        torques.clear();
+        inverseMass.clear();
+        inverseInertia.clear();
+        lastPosition.clear();
+        lastRotation.clear();
+        type.clear();
+        sleep.clear();
+        stampPosition.clear();
+        stampRotation.clear();
+        transformStamp.clear();
+        body.clear();
+    }
+
+    size_t BodyStore::size() const
+    {
+        return body.size();
+    }
+
+    void BodyStore::updateTransformStamps()
+    {
+        for (size_t i = 0; i < position.size(); ++i)
+        {
+            if (stampRotation[i] == rotation[i] && stampPosition[i].x == position[i].x &&
+                stampPosition[i].y == position[i].y)
+                continue;
+            stampPosition[i] = position[i];
+            stampRotation[i] = rotation[i];
+            ++transformStamp[i];
+        }
+    }
+
+    void BodyStore::updateRotations()
+    {
+        for (size_t i = 0; i < rotation.size(); ++i)
+        {
+            if (matrixRotation[i] == rotation[i])
+                continue;
+            rotationMatrix[i].set(rotation[i]);
+            matrixRotation[i] = rotation[i];
+        }
+    }
+
     void Body::PhysicsAttribute::step(const real& dt)
     {
         position += velocity * dt;
@@ -4,470 +4,892 @@
 
 namespace Physics2D
 {
+	ContactConstraintPoint* ContactManifold::begin()
+	{
+		return points;
+	}
+
+	ContactConstraintPoint* ContactManifold::end()
+	{
+		return points + count;
+	}
+
+	const ContactConstraintPoint* ContactManifold::begin() const
+	{
+		return points;
+	}
+
+	const ContactConstraintPoint* ContactManifold::end() const
+	{
+		return points + count;
+	}
+
+	ContactConstraintPoint& ContactManifold::operator[](size_t index)
+	{
+		assert(index < count);
+		return points[index];
+	}
+
+	const ContactConstraintPoint& ContactManifold::operator[](size_t index) const
+	{
+		assert(index < count);
+		return points[index];
+	}
+
+	ContactConstraintPoint& ContactManifold::front()
+	{
+		return (*this)[0];
+	}
+
+	const ContactConstraintPoint& ContactManifold::front() const
+	{
+		return (*this)[0];
+	}
+
+	size_t ContactManifold::size() const
+	{
+		return count;
+	}
+
+	bool ContactManifold::empty() const
+	{
+		return count == 0;
+	}
+
+	ContactConstraintPoint& ContactManifold::emplace_back(const ContactConstraintPoint& ccp)
+	{
+		assert(count < Capacity);
+		points[count] = ccp;
+		return points[count++];
+	}
+
+	size_t ContactIndex::home(const Body::BodyPair::BodyPairID& relation) const
+	{
+		//fibonacci hashing, the table size is always a power of two
+		return static_cast<size_t>((relation * 0x9E3779B97F4A7C15ull) >> 32) & (m_entries.size() - 1);
+	}
+
+	Index ContactIndex::find(const Body::BodyPair::BodyPairID& relation) const
+	{
+		if (m_entries.empty())
+			return InvalidSlot;
+		const size_t mask = m_entries.size() - 1;
+		for (size_t i = home(relation);; i = (i + 1) & mask)
+		{
+			const Entry& entry = m_entries[i];
+			if (entry.slot == InvalidSlot || entry.relation == relation)
+				return entry.slot;
+		}
+	}
+
+	void ContactIndex::insert(const Body::BodyPair::BodyPairID& relation, Index slot)
+	{
+		//keep the load factor at or below one half
+		if ((m_count + 1) * 2 > m_entries.size())
+			grow();
+		const size_t mask = m_entries.size() - 1;
+		for (size_t i = home(relation);; i = (i + 1) & mask)
+		{
+			Entry& entry = m_entries[i];
+			if (entry.slot == InvalidSlot)
+			{
+				entry.relation = relation;
+				entry.slot = slot;
+				++m_count;
+				return;
+			}
+			if (entry.relation == relation)
+			{
+				entry.slot = slot;
+				return;
+			}
+		}
+	}
+
+	void ContactIndex::erase(const Body::BodyPair::BodyPairID& relation)
+	{
+		if (m_entries.empty())
+			return;
+		const size_t mask = m_entries.size() - 1;
+		size_t hole = home(relation);
+		for (;; hole = (hole + 1) & mask)
+		{
+			if (m_entries[hole].slot == InvalidSlot)
+				return;
+			if (m_entries[hole].relation == relation)
+				break;
+		}
+
+		//shift later entries of the probe sequence back so that lookups never stop at the hole
+		for (size_t i = (hole + 1) & mask; m_entries[i].slot != InvalidSlot; i = (i + 1) & mask)
+		{
+			const size_t distance = (i - home(m_entries[i].relation)) & mask;
+			if (distance >= ((i - hole) & mask))
+			{
+				m_entries[hole] = m_entries[i];
+				hole = i;
+			}
+		}
+		m_entries[hole] = Entry();
+		--m_count;
+	}
+
+	void ContactIndex::clear()
+	{
+		std::fill(m_entries.begin(), m_entries.end(), Entry());
+		m_count = 0;
+	}
+
+	void ContactIndex::grow()
+	{
+		Container::Vector<Entry> entries(std::max(m_entries.size() * 2, static_cast<size_t>(64)));
+		std::swap(entries, m_entries);
+		m_count = 0;
+		for (const Entry& entry : entries)
+			if (entry.slot != InvalidSlot)
+				insert(entry.relation, entry.slot);
+	}
+
 	void ContactMaintainer::clearAll()
 	{
 		m_contactTable.clear();
+		m_contactIndex.clear();
 	}
 
 	void ContactMaintainer::solveVelocity(real dt)
 	{
-		for (auto&& elem : m_contactTable)
+		for (auto& contactList : m_contactTable)
+			solveVelocity(contactList, dt);
+	}
+
+	void ContactMaintainer::solveVelocity(ContactManifold& contactList, real dt)
+	{
+		if (contactList.empty())
+			return;
+
+		//solve friction first
+		for (auto&& ccp : contactList)
 		{
-			if (elem.second.empty())
+			if (!ccp.active)
 				continue;
 
-			//solve friction first
-			for (auto&& ccp : elem.second)
-			{
-				if (!ccp.active)
-					continue;
+			auto& vcp = ccp.vcp;
+			vcp.va = ccp.bodyA->velocity() + Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
+			vcp.vb = ccp.bodyB->velocity() + Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
+			Vector2 dv = vcp.va - vcp.vb;
 
-				auto& vcp = ccp.vcp;
-				vcp.va = ccp.bodyA->velocity() + Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
-				vcp.vb = ccp.bodyB->velocity() + Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
-				Vector2 dv = vcp.va - vcp.vb;
+			real jvt = vcp.tangent.dot(dv);
+			real lambda_t = vcp.effectiveMassTangent * -jvt;
 
-				real jvt = vcp.tangent.dot(dv);
-				real lambda_t = vcp.effectiveMassTangent * -jvt;
+			real maxFriction = ccp.friction * vcp.accumulatedNormalImpulse;
+			real newImpulse = Math::clamp(vcp.accumulatedTangentImpulse + lambda_t, -maxFriction, maxFriction);
+			lambda_t = newImpulse - vcp.accumulatedTangentImpulse;
+			vcp.accumulatedTangentImpulse = newImpulse;
 
-				real maxFriction = ccp.friction * vcp.accumulatedNormalImpulse;
-				real newImpulse = Math::clamp(vcp.accumulatedTangentImpulse + lambda_t, -maxFriction, maxFriction);
-				lambda_t = newImpulse - vcp.accumulatedTangentImpulse;
-				vcp.accumulatedTangentImpulse = newImpulse;
+			Vector2 impulse_t = lambda_t * vcp.tangent;
 
-				Vector2 impulse_t = lambda_t * vcp.tangent;
+			ccp.bodyA->applyImpulse(impulse_t, vcp.ra);
+			ccp.bodyB->applyImpulse(-impulse_t, vcp.rb);
+		}
 
-				ccp.bodyA->applyImpulse(impulse_t, vcp.ra);
-				ccp.bodyB->applyImpulse(-impulse_t, vcp.rb);
-			}
+		//the block solver needs both points, otherwise fall back to solving them one by one
+		if(m_velocityBlockSolver && contactList.size() == 2 && contactList[0].active && contactList[1].active)
+		{
+			//start block solver
+			auto& ccp = contactList[0];
 
-			if(m_velocityBlockSolver && elem.second.size() == 2)
-			{
-				//start block solver
-				if (!elem.second[0].active || !elem.second[1].active)
-					return;
-
-				auto& ccp = elem.second[0];
-
-				Body* bodyA = elem.second[0].bodyA;
-				Body* bodyB = elem.second[0].bodyB;
-
-				auto& vcp1 = elem.second[0].vcp;
-				auto& vcp2 = elem.second[1].vcp;
-
-				Vector2 wa1 = Vector2::crossProduct(bodyA->angularVelocity(), vcp1.ra);
-				Vector2 wb1 = Vector2::crossProduct(bodyB->angularVelocity(), vcp1.rb);
-				vcp1.va = bodyA->velocity() + wa1;
-				vcp1.vb = bodyB->velocity() + wb1;
-
-				Vector2 wa2 = Vector2::crossProduct(bodyA->angularVelocity(), vcp2.ra);
-				Vector2 wb2 = Vector2::crossProduct(bodyB->angularVelocity(), vcp2.rb);
-				vcp2.va = bodyA->velocity() + wa2;
-				vcp2.vb = bodyB->velocity() + wb2;
-
-				Vector2 dv1 = vcp1.va - vcp1.vb;
-				Vector2 dv2 = vcp2.va - vcp2.vb;
-
-				Vector2 normal = vcp1.normal;
-
-				real jv1 = normal.dot(dv1 - vcp1.velocityBias);
-				real jv2 = normal.dot(dv2 - vcp2.velocityBias);
-
-
-
-				//build quadratic programming:
-
-				//min_{x} 0.5 * x^T * A * x + b^T * x
-				//differentiate: f(x) = Ax + b
-				//it is better that Ax + b = 0
-
-				//for(;;)
-				//{
-				//	//1. b_1 < 0 && b_2 < 0
-				//	if(nb.x < 0.0f && nb.y < 0.0f)
-				//	{
-				//		nx = ccp.normalMass.multiply(-nb);
-				//		if(nx.x < 0.0f || nx.y < 0.0f)
-				//		{
-				//			//hit error point
-				//			int a = 0;
-				//		}
-				//		break;
-				//	}
-				//	//2. b_1 < 0 && b_2 > 0
-				//	if(nb.x < 0.0f && nb.y >= 0.0f)
-				//	{
-				//		nx.x = vcp1.effectiveMassNormal * -nb.x;
-				//		nx.y = 0.0f;
-				//		if (nx.x < 0.0f || nx.y < 0.0f)
-				//		{
-				//			//hit error point
-				//			int a = 0;
-				//		}
-				//		break;
-				//	}
-				//	//3. b_1 > 0 && b_2 < 0
-				//	if(nb.x >= 0.0f && nb.y < 0.0f)
-				//	{
-				//		nx.x = 0.0f;
-				//		nx.y = vcp2.effectiveMassNormal * -nb.y;
-				//		if (nx.x < 0.0f || nx.y < 0.0f)
-				//		{
-				//			//hit error point
-				//			int a = 0;
-				//		}
-				//		break;
-				//	}
-				//	//4. b_1 > 0 && b_2 > 0
-				//	if(nb.x >= 0.0f && nb.y >= 0.0f)
-				//	{
-				//		nx.clear();
-				//		break;
-				//	}
-				//	break;
-				//}
-				////clamp or projected
-				//nx.x = Math::max(nx.x, 0.0f);
-				//nx.y = Math::max(nx.y, 0.0f);
-
-				//LCP: y = Ax + b, x >= 0, y >= 0, xy = 0
-				//A: ccp.K
-				//A^{-1}: ccp.normalMass
-				//b: [jv1, jv2]
-				//x: [lambda1, lambda2]
-				//nx: next x
-				//d: delta x
-				Matrix2x2 A = ccp.k;
-				Vector2 b(jv1, jv2);
-				Vector2 x(vcp1.accumulatedNormalImpulse, vcp2.accumulatedNormalImpulse);
-				Vector2 nx;
-				Vector2 d;
+			Body* bodyA = contactList[0].bodyA;
+			Body* bodyB = contactList[0].bodyB;
 
-				b = b - A.multiply(x);
+			auto& vcp1 = contactList[0].vcp;
+			auto& vcp2 = contactList[1].vcp;
 
-				for(;;)
-				{
-					//1. b_1 < 0 && b_2 < 0
-					nx = ccp.normalMass.multiply(-b);
-					if(nx.x >= 0.0f && nx.y >= 0.0f)
-						break;
-					
-					//2. b_1 < 0 && b_2 > 0
-					nx.x = vcp1.effectiveMassNormal * -b.x;
-					nx.y = 0.0f;
-					jv1 = 0.0f;
-					jv2 = A.e12() * nx.x + b.y;
-					if(nx.x >= 0.0f && jv2 >= 0.0f)
-						break;
-					
-					//3. b_1 > 0 && b_2 < 0
-					nx.x = 0.0f;
-					nx.y = -vcp2.effectiveMassNormal * b.y;
-					jv1 = A.e21() * nx.y + b.x;
-					jv2 = 0.0f;
-					if(nx.y >= 0.0f && jv1 >= 0.0f)
-						break;
-					
-					//4. b_1 > 0 && b_2 > 0
-					nx.clear();
-					jv1 = b.x;
-					jv2 = b.y;
-					if(jv1 >= 0.0f && jv2 >= 0.0f)
-						break;
-					
-					//hit the unknown cases
-					int a = 0;
+			Vector2 wa1 = Vector2::crossProduct(bodyA->angularVelocity(), vcp1.ra);
+			Vector2 wb1 = Vector2::crossProduct(bodyB->angularVelocity(), vcp1.rb);
+			vcp1.va = bodyA->velocity() + wa1;
+			vcp1.vb = bodyB->velocity() + wb1;
+
+			Vector2 wa2 = Vector2::crossProduct(bodyA->angularVelocity(), vcp2.ra);
+			Vector2 wb2 = Vector2::crossProduct(bodyB->angularVelocity(), vcp2.rb);
+			vcp2.va = bodyA->velocity() + wa2;
+			vcp2.vb = bodyB->velocity() + wb2;
+
+			Vector2 dv1 = vcp1.va - vcp1.vb;
+			Vector2 dv2 = vcp2.va - vcp2.vb;
+
+			Vector2 normal = vcp1.normal;
+
+			real jv1 = normal.dot(dv1 + vcp1.velocityBias);
+			real jv2 = normal.dot(dv2 + vcp2.velocityBias);
+
+
+
+			//build quadratic programming:
+
+			//min_{x} 0.5 * x^T * A * x + b^T * x
+			//differentiate: f(x) = Ax + b
+			//it is better that Ax + b = 0
+
+			//for(;;)
+			//{
+			//	//1. b_1 < 0 && b_2 < 0
+			//	if(nb.x < 0.0f && nb.y < 0.0f)
+			//	{
+			//		nx = ccp.normalMass.multiply(-nb);
+			//		if(nx.x < 0.0f || nx.y < 0.0f)
+			//		{
+			//			//hit error point
+			//			int a = 0;
+			//		}
+			//		break;
+			//	}
+			//	//2. b_1 < 0 && b_2 > 0
+			//	if(nb.x < 0.0f && nb.y >= 0.0f)
+			//	{
+			//		nx.x = vcp1.effectiveMassNormal * -nb.x;
+			//		nx.y = 0.0f;
+			//		if (nx.x < 0.0f || nx.y < 0.0f)
+			//		{
+			//			//hit error point
+			//			int a = 0;
+			//		}
+			//		break;
+			//	}
+			//	//3. b_1 > 0 && b_2 < 0
+			//	if(nb.x >= 0.0f && nb.y < 0.0f)
+			//	{
+			//		nx.x = 0.0f;
+			//		nx.y = vcp2.effectiveMassNormal * -nb.y;
+			//		if (nx.x < 0.0f || nx.y < 0.0f)
+			//		{
+			//			//hit error point
+			//			int a = 0;
+			//		}
+			//		break;
+			//	}
+			//	//4. b_1 > 0 && b_2 > 0
+			//	if(nb.x >= 0.0f && nb.y >= 0.0f)
+			//	{
+			//		nx.clear();
+			//		break;
+			//	}
+			//	break;
+			//}
+			////clamp or projected
+			//nx.x = Math::max(nx.x, 0.0f);
+			//nx.y = Math::max(nx.y, 0.0f);
+
+			//LCP: y = Ax + b, x >= 0, y >= 0, xy = 0
+			//A: ccp.K
+			//A^{-1}: ccp.normalMass
+			//b: [jv1, jv2]
+			//x: [lambda1, lambda2]
+			//nx: next x
+			//d: delta x
+			Matrix2x2 A = ccp.k;
+			Vector2 b(jv1, jv2);
+			Vector2 x(vcp1.accumulatedNormalImpulse, vcp2.accumulatedNormalImpulse);
+			Vector2 nx;
+			Vector2 d;
+
+			b = b - A.multiply(x);
+
+			for(;;)
+			{
+				//1. b_1 < 0 && b_2 < 0
+				nx = ccp.normalMass.multiply(-b);
+				if(nx.x >= 0.0f && nx.y >= 0.0f)
 					break;
-				}
+				
+				//2. b_1 < 0 && b_2 > 0
+				nx.x = vcp1.effectiveMassNormal * -b.x;
+				nx.y = 0.0f;
+				jv1 = 0.0f;
+				jv2 = A.e12() * nx.x + b.y;
+				if(nx.x >= 0.0f && jv2 >= 0.0f)
+					break;
+				
+				//3. b_1 > 0 && b_2 < 0
+				nx.x = 0.0f;
+				nx.y = -vcp2.effectiveMassNormal * b.y;
+				jv1 = A.e21() * nx.y + b.x;
+				jv2 = 0.0f;
+				if(nx.y >= 0.0f && jv1 >= 0.0f)
+					break;
+				
+				//4. b_1 > 0 && b_2 > 0
+				nx.clear();
+				jv1 = b.x;
+				jv2 = b.y;
+				if(jv1 >= 0.0f && jv2 >= 0.0f)
+					break;
+				
+				//hit the unknown cases
+				int a = 0;
+				break;
+			}
 
 
-				d = nx - x;
+			d = nx - x;
 
-				real& lambda_1 = d.x;
-				real& lambda_2 = d.y;
+			real& lambda_1 = d.x;
+			real& lambda_2 = d.y;
 
-				Vector2 impulse_1 = lambda_1 * normal;
-				Vector2 impulse_2 = lambda_2 * normal;
+			Vector2 impulse_1 = lambda_1 * normal;
+			Vector2 impulse_2 = lambda_2 * normal;
 
-				bodyA->applyImpulse(impulse_1, vcp1.ra);
-				bodyB->applyImpulse(-impulse_1, vcp1.rb);
+			bodyA->applyImpulse(impulse_1, vcp1.ra);
+			bodyB->applyImpulse(-impulse_1, vcp1.rb);
 
-				bodyA->applyImpulse(impulse_2, vcp2.ra);
-				bodyB->applyImpulse(-impulse_2, vcp2.rb);
+			bodyA->applyImpulse(impulse_2, vcp2.ra);
+			bodyB->applyImpulse(-impulse_2, vcp2.rb);
 
-				vcp1.accumulatedNormalImpulse = nx.x;
-				vcp2.accumulatedNormalImpulse = nx.y;
+			vcp1.accumulatedNormalImpulse = nx.x;
+			vcp2.accumulatedNormalImpulse = nx.y;
 
-				//use fixed point iteration(projected gradient method)
+			//use fixed point iteration(projected gradient method)
 
-				
+			
 
-				//Vector2 x;
+			//Vector2 x;
 
-				//const real alpha = 0.1f;
+			//const real alpha = 0.1f;
 
-				//const int maxIteration = 1000;
+			//const int maxIteration = 1000;
 
 
 
-				//for(int i = 0;i < maxIteration; ++i)
-				//{
-				//	Vector2 dx = alpha * (A.multiply(x) + b);
-				//	assert(!std::isinf(dx.x));
-				//	assert(!std::isinf(dx.y));
-				//	assert(!std::isinf(x.x));
-				//	assert(!std::isinf(x.y));
-				//	Vector2 nx = x - dx;
+			//for(int i = 0;i < maxIteration; ++i)
+			//{
+			//	Vector2 dx = alpha * (A.multiply(x) + b);
+			//	assert(!std::isinf(dx.x));
+			//	assert(!std::isinf(dx.y));
+			//	assert(!std::isinf(x.x));
+			//	assert(!std::isinf(x.y));
+			//	Vector2 nx = x - dx;
 
-				//	//clamp nx >= 0
-				//	nx.x = Math::max(nx.x, 0.0f);
-				//	nx.y = Math::max(nx.y, 0.0f);
-				//	//alert nan
+			//	//clamp nx >= 0
+			//	nx.x = Math::max(nx.x, 0.0f);
+			//	nx.y = Math::max(nx.y, 0.0f);
+			//	//alert nan
 
-				//	//if change is too small then break
-				//	if ((nx - x).lengthSquare() < 1e-6f)
-				//		break;
+			//	//if change is too small then break
+			//	if ((nx - x).lengthSquare() < 1e-6f)
+			//		break;
 
-				//	x = nx;
-				//}
+			//	x = nx;
+			//}
 
 
-				//real& lambda_1 = x.x;
-				//real& lambda_2 = x.y;
+			//real& lambda_1 = x.x;
+			//real& lambda_2 = x.y;
 
-				//Vector2 impulse_1 = lambda_1 * vcp1.normal;
-				//Vector2 impulse_2 = lambda_2 * vcp2.normal;
+			//Vector2 impulse_1 = lambda_1 * vcp1.normal;
+			//Vector2 impulse_2 = lambda_2 * vcp2.normal;
 
-				//apply impulse to bodyA, bodyB
+			//apply impulse to bodyA, bodyB
 
 
-			}
-			else
+		}
+		else
+		{
+			for (auto&& ccp : contactList)
 			{
-				for (auto&& ccp : elem.second)
-				{
-					if (!ccp.active)
-						continue;
+				if (!ccp.active)
+					continue;
 
-					auto& vcp = ccp.vcp;
+				auto& vcp = ccp.vcp;
 
-					Vector2 wa = Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
-					Vector2 wb = Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
-					vcp.va = ccp.bodyA->velocity() + wa;
-					vcp.vb = ccp.bodyB->velocity() + wb;
+				Vector2 wa = Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
+				Vector2 wb = Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
+				vcp.va = ccp.bodyA->velocity() + wa;
+				vcp.vb = ccp.bodyB->velocity() + wb;
 
-					Vector2 dv = vcp.va - vcp.vb;
-					real jv = vcp.normal.dot(dv + vcp.velocityBias);
-					real lambda_n = vcp.effectiveMassNormal * -jv;
-					real oldImpulse = vcp.accumulatedNormalImpulse;
-					vcp.accumulatedNormalImpulse = Math::max(oldImpulse + lambda_n, 0);
-					lambda_n = vcp.accumulatedNormalImpulse - oldImpulse;
+				Vector2 dv = vcp.va - vcp.vb;
+				real jv = vcp.normal.dot(dv + vcp.velocityBias);
+				real lambda_n = vcp.effectiveMassNormal * -jv;
+				real oldImpulse = vcp.accumulatedNormalImpulse;
+				vcp.accumulatedNormalImpulse = Math::max(oldImpulse + lambda_n, 0);
+				lambda_n = vcp.accumulatedNormalImpulse - oldImpulse;
 
-					Vector2 impulse_n = lambda_n * vcp.normal;
+				Vector2 impulse_n = lambda_n * vcp.normal;
 
-					ccp.bodyA->applyImpulse(impulse_n, vcp.ra);
-					ccp.bodyB->applyImpulse(-impulse_n, vcp.rb);
-				}
+				ccp.bodyA->applyImpulse(impulse_n, vcp.ra);
+				ccp.bodyB->applyImpulse(-impulse_n, vcp.rb);
 			}
-
 		}
 	}
 
-	void ContactMaintainer::solveRestitution(real dt)
+	void ContactMaintainer::prepare(WideContactConstraint& wide, ContactManifold* const* contactLists, size_t count) const
 	{
-		for (auto&& elem : m_contactTable)
+		assert(count <= WideContactConstraint::LaneCount);
+		wide = WideContactConstraint();
+		wide.laneCount = count;
+		for (size_t lane = 0; lane < count; ++lane)
 		{
-			if (elem.second.empty())
-				continue;
-			for (auto&& ccp : elem.second)
+			auto& contactList = *contactLists[lane];
+			Body* bodyA = contactList.front().bodyA;
+			Body* bodyB = contactList.front().bodyB;
+			wide.bodyA[lane] = bodyA->storeIndex();
+			wide.bodyB[lane] = bodyB->storeIndex();
+			wide.writeA[lane] = bodyA->inverseMass() != 0.0f || bodyA->inverseInertia() != 0.0f;
+			wide.writeB[lane] = bodyB->inverseMass() != 0.0f || bodyB->inverseInertia() != 0.0f;
+			wide.inverseMassA[lane] = bodyA->inverseMass();
+			wide.inverseInertiaA[lane] = bodyA->inverseInertia();
+			wide.inverseMassB[lane] = bodyB->inverseMass();
+			wide.inverseInertiaB[lane] = bodyB->inverseInertia();
+			wide.normalX[lane] = contactList.front().vcp.normal.x;
+			wide.normalY[lane] = contactList.front().vcp.normal.y;
+			wide.tangentX[lane] = contactList.front().vcp.tangent.x;
+			wide.tangentY[lane] = contactList.front().vcp.tangent.y;
+			wide.friction[lane] = contactList.front().friction;
+
+			size_t point = 0;
+			for (auto&& ccp : contactList)
 			{
-				if (!ccp.active)
+				if (!ccp.active || point == WideContactConstraint::PointCount)
 					continue;
-
 				auto& vcp = ccp.vcp;
+				wide.points[point][lane] = &ccp;
+				wide.raX[point][lane] = vcp.ra.x;
+				wide.raY[point][lane] = vcp.ra.y;
+				wide.rbX[point][lane] = vcp.rb.x;
+				wide.rbY[point][lane] = vcp.rb.y;
+				wide.bias[point][lane] = vcp.normal.dot(vcp.velocityBias);
+				wide.effectiveMassNormal[point][lane] = vcp.effectiveMassNormal;
+				wide.effectiveMassTangent[point][lane] = vcp.effectiveMassTangent;
+				wide.normalImpulse[point][lane] = vcp.accumulatedNormalImpulse;
+				wide.tangentImpulse[point][lane] = vcp.accumulatedTangentImpulse;
+				++point;
+			}
+		}
+	}
+
+	void ContactMaintainer::solveVelocity(WideContactConstraint& wide, BodyStore& store) const
+	{
+		constexpr size_t Lanes = WideContactConstraint::LaneCount;
+		alignas(16) float gather[6][Lanes] = {};
+		for (size_t lane = 0; lane < wide.laneCount; ++lane)
+		{
+			const Index a = wide.bodyA[lane];
+			const Index b = wide.bodyB[lane];
+			gather[0][lane] = store.velocity[a].x;
+			gather[1][lane] = store.velocity[a].y;
+			gather[2][lane] = store.angularVelocity[a];
+			gather[3][lane] = store.velocity[b].x;
+			gather[4][lane] = store.velocity[b].y;
+			gather[5][lane] = store.angularVelocity[b];
+		}
+
+		Float4 vax = Float4::load(gather[0]);
+		Float4 vay = Float4::load(gather[1]);
+		Float4 wa = Float4::load(gather[2]);
+		Float4 vbx = Float4::load(gather[3]);
+		Float4 vby = Float4::load(gather[4]);
+		Float4 wb = Float4::load(gather[5]);
+
+		const Float4 imA = Float4::load(wide.inverseMassA);
+		const Float4 iiA = Float4::load(wide.inverseInertiaA);
+		const Float4 imB = Float4::load(wide.inverseMassB);
+		const Float4 iiB = Float4::load(wide.inverseInertiaB);
+		const Float4 nx = Float4::load(wide.normalX);
+		const Float4 ny = Float4::load(wide.normalY);
+		const Float4 tx = Float4::load(wide.tangentX);
+		const Float4 ty = Float4::load(wide.tangentY);
+		const Float4 friction = Float4::load(wide.friction);
+		const Float4 zero = Float4::set(0.0f);
+
+		//same order as the scalar solver: friction of both points first, then the normal of both points
+		auto apply = [&](const Float4& px, const Float4& py, const Float4& rax, const Float4& ray, const Float4& rbx, const Float4& rby)
+		{
+			vax = vax + imA * px;
+			vay = vay + imA * py;
+			wa = wa + iiA * (rax * py - ray * px);
+			vbx = vbx - imB * px;
+			vby = vby - imB * py;
+			wb = wb - iiB * (rbx * py - rby * px);
+		};
+
+		for (size_t point = 0; point < WideContactConstraint::PointCount; ++point)
+		{
+			const Float4 rax = Float4::load(wide.raX[point]);
+			const Float4 ray = Float4::load(wide.raY[point]);
+			const Float4 rbx = Float4::load(wide.rbX[point]);
+			const Float4 rby = Float4::load(wide.rbY[point]);
+			//va - vb with v + w x r
+			const Float4 dvx = vax - wa * ray - (vbx - wb * rby);
+			const Float4 dvy = vay + wa * rax - (vby + wb * rbx);
+
+			const Float4 lambda = Float4::load(wide.effectiveMassTangent[point]) * -(tx * dvx + ty * dvy);
+			const Float4 maxFriction = friction * Float4::load(wide.normalImpulse[point]);
+			const Float4 oldImpulse = Float4::load(wide.tangentImpulse[point]);
+			const Float4 newImpulse = max(min(oldImpulse + lambda, maxFriction), -maxFriction);
+			newImpulse.store(wide.tangentImpulse[point]);
+			const Float4 delta = newImpulse - oldImpulse;
+			apply(delta * tx, delta * ty, rax, ray, rbx, rby);
+		}
+
+		for (size_t point = 0; point < WideContactConstraint::PointCount; ++point)
+		{
+			const Float4 rax = Float4::load(wide.raX[point]);
+			const Float4 ray = Float4::load(wide.raY[point]);
+			const Float4 rbx = Float4::load(wide.rbX[point]);
+			const Float4 rby = Float4::load(wide.rbY[point]);
+			const Float4 dvx = vax - wa * ray - (vbx - wb * rby);
+			const Float4 dvy = vay + wa * rax - (vby + wb * rbx);
+
+			const Float4 jv = nx * dvx + ny * dvy + Float4::load(wide.bias[point]);
+			const Float4 lambda = Float4::load(wide.effectiveMassNormal[point]) * -jv;
+			const Float4 oldImpulse = Float4::load(wide.normalImpulse[point]);
+			const Float4 newImpulse = max(oldImpulse + lambda, zero);
+			newImpulse.store(wide.normalImpulse[point]);
+			const Float4 delta = newImpulse - oldImpulse;
+			apply(delta * nx, delta * ny, rax, ray, rbx, rby);
+		}
 
-				if(vcp.restitution == 0.0f || vcp.normal.isOrigin() && vcp.relativeVelocity < -1e-8f)
+		vax.store(gather[0]);
+		vay.store(gather[1]);
+		wa.store(gather[2]);
+		vbx.store(gather[3]);
+		vby.store(gather[4]);
+		wb.store(gather[5]);
+		for (size_t lane = 0; lane < wide.laneCount; ++lane)
+		{
+			if (wide.writeA[lane])
+			{
+				const Index a = wide.bodyA[lane];
+				store.velocity[a].set(gather[0][lane], gather[1][lane]);
+				store.angularVelocity[a] = gather[2][lane];
+			}
+			if (wide.writeB[lane])
+			{
+				const Index b = wide.bodyB[lane];
+				store.velocity[b].set(gather[3][lane], gather[4][lane]);
+				store.angularVelocity[b] = gather[5][lane];
+			}
+		}
+	}
+
+	void ContactMaintainer::storeImpulses(const WideContactConstraint& wide) const
+	{
+		for (size_t point = 0; point < WideContactConstraint::PointCount; ++point)
+		{
+			for (size_t lane = 0; lane < wide.laneCount; ++lane)
+			{
+				ContactConstraintPoint* ccp = wide.points[point][lane];
+				if (ccp == nullptr)
 					continue;
+				ccp->vcp.accumulatedNormalImpulse = wide.normalImpulse[point][lane];
+				ccp->vcp.accumulatedTangentImpulse = wide.tangentImpulse[point][lane];
+			}
+		}
+	}
 
-				Vector2 wa = Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
-				Vector2 wb = Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
-				vcp.va = ccp.bodyA->velocity() + wa;
-				vcp.vb = ccp.bodyB->velocity() + wb;
+	void ContactMaintainer::solveRestitution(real dt)
+	{
+		for (auto& contactList : m_contactTable)
+			solveRestitution(contactList, dt);
+	}
 
-				Vector2 dv = vcp.va - vcp.vb;
-				real jv = vcp.normal.dot(dv);
+	void ContactMaintainer::solveRestitution(ContactManifold& contactList, real dt)
+	{
+		for (auto&& ccp : contactList)
+		{
+			if (!ccp.active)
+				continue;
 
-				real lambda_r = vcp.effectiveMassNormal * -(jv + vcp.restitution * vcp.relativeVelocity);
+			auto& vcp = ccp.vcp;
 
-				Vector2 impulse_r = lambda_r * vcp.normal;
+			if(vcp.restitution == 0.0f || vcp.normal.isOrigin() && vcp.relativeVelocity < -1e-8f)
+				continue;
+			//a speculative point that the solver never pushed did not hit anything in this step
+			if (vcp.accumulatedNormalImpulse == 0.0f && vcp.normal.dot(vcp.velocityBias) > 0.0f)
+				continue;
 
-				ccp.bodyA->applyImpulse(impulse_r, vcp.ra);
-				ccp.bodyB->applyImpulse(-impulse_r, vcp.rb);
-			}
+			Vector2 wa = Vector2::crossProduct(ccp.bodyA->angularVelocity(), vcp.ra);
+			Vector2 wb = Vector2::crossProduct(ccp.bodyB->angularVelocity(), vcp.rb);
+			vcp.va = ccp.bodyA->velocity() + wa;
+			vcp.vb = ccp.bodyB->velocity() + wb;
+
+			Vector2 dv = vcp.va - vcp.vb;
+			real jv = vcp.normal.dot(dv);
+
+			real lambda_r = vcp.effectiveMassNormal * -(jv + vcp.restitution * vcp.relativeVelocity);
+
+			Vector2 impulse_r = lambda_r * vcp.normal;
+
+			ccp.bodyA->applyImpulse(impulse_r, vcp.ra);
+			ccp.bodyB->applyImpulse(-impulse_r, vcp.rb);
 		}
 	}
 
 	void ContactMaintainer::solvePosition(real dt)
 	{
-		for (auto&& elem : m_contactTable)
+		for (auto& contactList : m_contactTable)
+			solvePosition(contactList, dt);
+	}
+
+	void ContactMaintainer::solvePosition(ContactManifold& contactList, real dt)
+	{
+		if (contactList.empty() || !contactList[0].active)
+			return;
+		for (;;)
 		{
-			if (elem.second.empty() || !elem.second[0].active)
-				continue;
-			for (;;)
+			if (m_positionBlockSolver && contactList.size() == 2)
 			{
-				if (m_positionBlockSolver && elem.second.size() == 2)
+				//start block solver
+				auto&& vcp1 = contactList[0].vcp;
+				auto&& vcp2 = contactList[1].vcp;
+				Body* bodyA = contactList[0].bodyA;
+				Body* bodyB = contactList[0].bodyB;
+
+				Vector2 pa1 = bodyA->toWorldPoint(vcp1.localA);
+				Vector2 pb1 = bodyB->toWorldPoint(vcp1.localB);
+				Vector2 pa2 = bodyA->toWorldPoint(vcp2.localA);
+				Vector2 pb2 = bodyB->toWorldPoint(vcp2.localB);
+
+				Vector2 ra1 = pa1 - bodyA->position();
+				Vector2 rb1 = pb1 - bodyB->position();
+				Vector2 ra2 = pa2 - bodyA->position();
+				Vector2 rb2 = pb2 - bodyB->position();
+
+				Vector2 c1 = pb1 - pa1;
+				Vector2 c2 = pb2 - pa2;
+
+				real bias1 = Math::max(m_biasFactor * (c1.dot(vcp1.normal) - m_maxPenetration), 0.0f);
+				real bias2 = Math::max(m_biasFactor * (c2.dot(vcp2.normal) - m_maxPenetration), 0.0f);
+
+				const real bias = Math::min(bias1, bias2);
+
+				bias1 = -bias;
+				bias2 = -bias;
+
+				const real im_a = bodyA->inverseMass();
+				const real im_b = bodyB->inverseMass();
+				const real ii_a = bodyA->inverseInertia();
+				const real ii_b = bodyB->inverseInertia();
+
+				real rn1A = ra1.cross(vcp1.normal);
+				real rn1B = rb1.cross(vcp1.normal);
+				real rn2A = ra2.cross(vcp2.normal);
+				real rn2B = rb2.cross(vcp2.normal);
+
+				real k11 = im_a + ii_a * rn1A * rn1A + im_b + ii_b * rn1B * rn1B;
+				real k12 = im_a + ii_a * rn1A * rn2A + im_b + ii_b * rn1B * rn2B;
+				real k22 = im_a + ii_a * rn2A * rn2A + im_b + ii_b * rn2B * rn2B;
+
+				real determinant = (k11 * k22 - k12 * k12);
+				real d1 = k11 * k11;
+				real d2 = 1000.0f * (k11 * k22 - k12 * k12);
+				bool conditioner = k11 * k11 < 1000.0f * (k11 * k22 - k12 * k12);
+
+				//numerical stability check to ensure invertible matrix
+				Matrix2x2 A;
+				Matrix2x2 invA;
+				if (conditioner)
 				{
-					//start block solver
-					auto&& vcp1 = elem.second[0].vcp;
-					auto&& vcp2 = elem.second[1].vcp;
-					Body* bodyA = elem.second[0].bodyA;
-					Body* bodyB = elem.second[0].bodyB;
-
-					Vector2 pa1 = bodyA->toWorldPoint(vcp1.localA);
-					Vector2 pb1 = bodyB->toWorldPoint(vcp1.localB);
-					Vector2 pa2 = bodyA->toWorldPoint(vcp2.localA);
-					Vector2 pb2 = bodyB->toWorldPoint(vcp2.localB);
-
-					Vector2 ra1 = pa1 - bodyA->position();
-					Vector2 rb1 = pb1 - bodyB->position();
-					Vector2 ra2 = pa2 - bodyA->position();
-					Vector2 rb2 = pb2 - bodyB->position();
-
-					Vector2 c1 = pb1 - pa1;
-					Vector2 c2 = pb2 - pa2;
-
-					real bias1 = Math::max(m_biasFactor * (c1.dot(vcp1.normal) - m_maxPenetration), 0.0f);
-					real bias2 = Math::max(m_biasFactor * (c2.dot(vcp2.normal) - m_maxPenetration), 0.0f);
-
-					const real bias = Math::min(bias1, bias2);
-
-					bias1 = -bias;
-					bias2 = -bias;
-
-					const real im_a = bodyA->inverseMass();
-					const real im_b = bodyB->inverseMass();
-					const real ii_a = bodyA->inverseInertia();
-					const real ii_b = bodyB->inverseInertia();
-
-					real rn1A = ra1.cross(vcp1.normal);
-					real rn1B = rb1.cross(vcp1.normal);
-					real rn2A = ra2.cross(vcp2.normal);
-					real rn2B = rb2.cross(vcp2.normal);
-
-					real k11 = im_a + ii_a * rn1A * rn1A + im_b + ii_b * rn1B * rn1B;
-					real k12 = im_a + ii_a * rn1A * rn2A + im_b + ii_b * rn1B * rn2B;
-					real k22 = im_a + ii_a * rn2A * rn2A + im_b + ii_b * rn2B * rn2B;
-
-					real determinant = (k11 * k22 - k12 * k12);
-					real d1 = k11 * k11;
-					real d2 = 1000.0f * (k11 * k22 - k12 * k12);
-					bool conditioner = k11 * k11 < 1000.0f * (k11 * k22 - k12 * k12);
-
-					//numerical stability check to ensure invertible matrix
-					Matrix2x2 A;
-					Matrix2x2 invA;
-					if (conditioner)
-					{
-						A.set(k11, k12, k12, k22);
-						invA = A;
-						invA.invert();
-					}
-					else
-						break;
+					A.set(k11, k12, k12, k22);
+					invA = A;
+					invA.invert();
+				}
+				else
+					break;
 
 
-					Vector2 b(bias1, bias2);
-					Vector2 d;
+				Vector2 b(bias1, bias2);
+				Vector2 d;
 
-					for (;;)
+				for (;;)
+				{
+					//1. b_1 < 0 && b_2 < 0
+					Vector2 x = invA.multiply(-b);
+					if (x.x >= 0.0f && x.y >= 0.0f)
 					{
-						//1. b_1 < 0 && b_2 < 0
-						Vector2 x = invA.multiply(-b);
-						if (x.x >= 0.0f && x.y >= 0.0f)
-						{
-							d = x;
-							break;
-						}
-						//2. b_1 < 0 && b_2 > 0
-						x.x = -b.x / k11;
-						x.y = 0.0f;
-						bias2 = A.e21() * x.x + b.y;
-						if (x.x >= 0.0f && bias2 >= 0.0f)
-						{
-							d = x;
-							break;
-						}
-
-						//3. b_1 > 0 && b_2 < 0
-						x.x = 0.0f;
-						x.y = -b.y / k22;
-						bias1 = A.e12() * x.y + b.x;
-						if (x.y >= 0.0f && bias1 >= 0.0f)
-						{
-							d = x;
-							break;
-						}
-
-						//4. b_1 > 0 && b_2 > 0
-						//d = zero
-
+						d = x;
+						break;
+					}
+					//2. b_1 < 0 && b_2 > 0
+					x.x = -b.x / k11;
+					x.y = 0.0f;
+					bias2 = A.e21() * x.x + b.y;
+					if (x.x >= 0.0f && bias2 >= 0.0f)
+					{
+						d = x;
 						break;
 					}
 
-					Vector2 impulse1 = vcp1.normal * d.x;
-					Vector2 impulse2 = vcp2.normal * d.y;
+					//3. b_1 > 0 && b_2 < 0
+					x.x = 0.0f;
+					x.y = -b.y / k22;
+					bias1 = A.e12() * x.y + b.x;
+					if (x.y >= 0.0f && bias1 >= 0.0f)
+					{
+						d = x;
+						break;
+					}
 
-					bodyA->position() += bodyA->inverseMass() * impulse1;
-					bodyA->rotation() += bodyA->inverseInertia() * ra1.cross(impulse1);
+					//4. b_1 > 0 && b_2 > 0
+					//d = zero
 
-					bodyB->position() -= bodyB->inverseMass() * impulse1;
-					bodyB->rotation() -= bodyB->inverseInertia() * rb1.cross(impulse1);
+					break;
+				}
 
-					bodyA->position() += bodyA->inverseMass() * impulse2;
-					bodyA->rotation() += bodyA->inverseInertia() * ra2.cross(impulse2);
+				Vector2 impulse1 = vcp1.normal * d.x;
+				Vector2 impulse2 = vcp2.normal * d.y;
 
-					bodyB->position() -= bodyB->inverseMass() * impulse2;
-					bodyB->rotation() -= bodyB->inverseInertia() * rb2.cross(impulse2);
-				}
-				break;
+				bodyA->applyPositionImpulse(impulse1, ra1);
+				bodyB->applyPositionImpulse(-impulse1, rb1);
+				bodyA->applyPositionImpulse(impulse2, ra2);
+				bodyB->applyPositionImpulse(-impulse2, rb2);
 			}
-			for (auto&& ccp : elem.second)
-			{
-				auto&& vcp = ccp.vcp;
-				Body* bodyA = ccp.bodyA;
-				Body* bodyB = ccp.bodyB;
-				Vector2 pa = bodyA->toWorldPoint(vcp.localA);
-				Vector2 pb = bodyB->toWorldPoint(vcp.localB);
-				Vector2 ra = pa - bodyA->position();
-				Vector2 rb = pb - bodyB->position();
-				Vector2 c = pb - pa;
+			break;
+		}
+		for (auto&& ccp : contactList)
+		{
+			auto&& vcp = ccp.vcp;
+			Body* bodyA = ccp.bodyA;
+			Body* bodyB = ccp.bodyB;
+			Vector2 pa = bodyA->toWorldPoint(vcp.localA);
+			Vector2 pb = bodyB->toWorldPoint(vcp.localB);
+			Vector2 ra = pa - bodyA->position();
+			Vector2 rb = pb - bodyB->position();
+			Vector2 c = pb - pa;
 
-				const real bias = Math::max(m_biasFactor * (c.dot(vcp.normal) - m_maxPenetration), 0.0f);
+			const real bias = Math::max(m_biasFactor * (c.dot(vcp.normal) - m_maxPenetration), 0.0f);
 
-				const real im_a = bodyA->inverseMass();
-				const real im_b = bodyB->inverseMass();
-				const real ii_a = bodyA->inverseInertia();
-				const real ii_b = bodyB->inverseInertia();
+			const real im_a = bodyA->inverseMass();
+			const real im_b = bodyB->inverseMass();
+			const real ii_a = bodyA->inverseInertia();
+			const real ii_b = bodyB->inverseInertia();
 
-				const real rn_a = ra.cross(vcp.normal);
-				const real rn_b = rb.cross(vcp.normal);
+			const real rn_a = ra.cross(vcp.normal);
+			const real rn_b = rb.cross(vcp.normal);
 
-				const real kNormal = im_a + ii_a * rn_a * rn_a +
-					im_b + ii_b * rn_b * rn_b;
+			const real kNormal = im_a + ii_a * rn_a * rn_a +
+				im_b + ii_b * rn_b * rn_b;
 
-				vcp.effectiveMassNormal = realEqual(kNormal, 0.0f) ? 0 : 1.0f / kNormal;
+			vcp.effectiveMassNormal = realEqual(kNormal, 0.0f) ? 0 : 1.0f / kNormal;
 
-				real lambda = vcp.effectiveMassNormal * bias;
-				lambda = Math::max(lambda, 0);
+			real lambda = vcp.effectiveMassNormal * bias;
+			lambda = Math::max(lambda, 0);
 
-				Vector2 impulse = lambda * vcp.normal;
+			Vector2 impulse = lambda * vcp.normal;
 
-				bodyA->position() += bodyA->inverseMass() * impulse;
-				bodyA->rotation() += bodyA->inverseInertia() * ra.cross(impulse);
+			bodyA->applyPositionImpulse(impulse, ra);
+			bodyB->applyPositionImpulse(-impulse, rb);
+		}
+	}
+
+	ContactSoftness ContactSoftness::make(const real& hertz, const real& dampingRatio, const real& h)
+	{
+		if (hertz == 0.0f)
+			return ContactSoftness();
+
+		const real omega = Constant::DoublePi * hertz;
+		const real a1 = 2.0f * dampingRatio + h * omega;
+		const real a2 = h * omega * a1;
+		const real a3 = 1.0f / (1.0f + a2);
+
+		ContactSoftness softness;
+		softness.biasRate = omega / a1;
+		softness.massScale = a2 * a3;
+		softness.impulseScale = a3;
+		return softness;
+	}
+
+	void ContactMaintainer::prepareSoftStep(real h)
+	{
+		//a spring faster than the sub-steps can follow would only add energy
+		const real hertz = Math::min(m_contactHertz, 0.25f / h);
+		m_softness = ContactSoftness::make(hertz, m_contactDampingRatio, h);
+		m_staticSoftness = ContactSoftness::make(2.0f * hertz, m_contactDampingRatio, h);
+	}
+
+	void ContactMaintainer::warmStart(ContactManifold& contactList)
+	{
+		if (!m_warmStart)
+			return;
+		for (auto&& ccp : contactList)
+		{
+			if (!ccp.active)
+				continue;
+			auto& vcp = ccp.vcp;
+			Vector2 impulse = vcp.accumulatedNormalImpulse * vcp.normal + vcp.accumulatedTangentImpulse * vcp.tangent;
+			ccp.bodyA->applyImpulse(impulse, vcp.ra);
+			ccp.bodyB->applyImpulse(-impulse, vcp.rb);
+		}
+	}
+
+	void ContactMaintainer::solveSoft(ContactManifold& contactList, real h, bool useBias)
+	{
+		if (contactList.empty())
+			return;
+
+		Body* bodyA = contactList.front().bodyA;
+		Body* bodyB = contactList.front().bodyB;
+		const ContactSoftness& softness = bodyA->inverseMass() == 0.0f || bodyB->inverseMass() == 0.0f ?
+			m_staticSoftness : m_softness;
 
-				bodyB->position() -= bodyB->inverseMass() * impulse;
-				bodyB->rotation() -= bodyB->inverseInertia() * rb.cross(impulse);
+		//the normal and the anchors stay those of the detection, only the separation is measured again
+		//at the poses the earlier sub-steps left
+		for (auto&& ccp : contactList)
+		{
+			if (!ccp.active)
+				continue;
+
+			auto& vcp = ccp.vcp;
+			const real separation = (bodyA->toWorldPoint(vcp.localA) - bodyB->toWorldPoint(vcp.localB)).dot(vcp.normal);
+
+			real bias = 0;
+			real massScale = 1;
+			real impulseScale = 0;
+			if (separation > 0)
+			{
+				//still apart, the gap may be closed within the sub-step
+				bias = separation / h;
 			}
+			else if (useBias)
+			{
+				bias = Math::max(softness.biasRate * Math::min(separation + m_maxPenetration, 0), -m_maxPushVelocity);
+				massScale = softness.massScale;
+				impulseScale = softness.impulseScale;
+			}
+
+			vcp.va = bodyA->velocity() + Vector2::crossProduct(bodyA->angularVelocity(), vcp.ra);
+			vcp.vb = bodyB->velocity() + Vector2::crossProduct(bodyB->angularVelocity(), vcp.rb);
+			real jv = vcp.normal.dot(vcp.va - vcp.vb);
+
+			real lambda_n = -vcp.effectiveMassNormal * massScale * (jv + bias) - impulseScale * vcp.accumulatedNormalImpulse;
+			real oldImpulse = vcp.accumulatedNormalImpulse;
+			vcp.accumulatedNormalImpulse = Math::max(oldImpulse + lambda_n, 0);
+			lambda_n = vcp.accumulatedNormalImpulse - oldImpulse;
+
+			Vector2 impulse_n = lambda_n * vcp.normal;
+			bodyA->applyImpulse(impulse_n, vcp.ra);
+			bodyB->applyImpulse(-impulse_n, vcp.rb);
+		}
+
+		//friction after the normal, so that it is bounded by the impulse of this sub-step
+		for (auto&& ccp : contactList)
+		{
+			if (!ccp.active)
+				continue;
+
+			auto& vcp = ccp.vcp;
+			vcp.va = bodyA->velocity() + Vector2::crossProduct(bodyA->angularVelocity(), vcp.ra);
+			vcp.vb = bodyB->velocity() + Vector2::crossProduct(bodyB->angularVelocity(), vcp.rb);
+
+			real jvt = vcp.tangent.dot(vcp.va - vcp.vb);
+			real lambda_t = vcp.effectiveMassTangent * -jvt;
+
+			real maxFriction = ccp.friction * vcp.accumulatedNormalImpulse;
+			real newImpulse = Math::clamp(vcp.accumulatedTangentImpulse + lambda_t, -maxFriction, maxFriction);
+			lambda_t = newImpulse - vcp.accumulatedTangentImpulse;
+			vcp.accumulatedTangentImpulse = newImpulse;
+
+			Vector2 impulse_t = lambda_t * vcp.tangent;
+			bodyA->applyImpulse(impulse_t, vcp.ra);
+			bodyB->applyImpulse(-impulse_t, vcp.rb);
 		}
 	}
 
@@ -475,43 +897,65 @@ namespace Physics2D
 	{
 		const Body* bodyA = collision.bodyA;
 		const Body* bodyB = collision.bodyB;
-		const bool isRoundA = bodyA->shape()->type() == ShapeType::Circle || bodyA->shape()->type() == ShapeType::Ellipse;
-		const bool isRoundB = bodyB->shape()->type() == ShapeType::Circle || bodyB->shape()->type() == ShapeType::Ellipse;
 		const auto relation = Body::BodyPair::generateBodyPairID(collision.bodyA, collision.bodyB);
-		auto& contactList = m_contactTable[relation];
-		uint32_t i = 0;
+		Index slot = m_contactIndex.find(relation);
+		if (slot == ContactIndex::InvalidSlot)
+		{
+			slot = static_cast<Index>(m_contactTable.size());
+			m_contactIndex.insert(relation, slot);
+			m_contactTable.emplace_back().relation = relation;
+		}
+		auto& contactList = m_contactTable[slot];
+
+		//the manifold is rebuilt from the new points, points of the last step with the same feature id
+		//pass on their accumulated impulses
+		const ContactManifold previous = contactList;
+		contactList.count = 0;
+		//an old point passes its impulses on to one new point at most, or warm starting applies them twice
+		bool used[ContactManifold::Capacity] = {};
 
-		for (; i < collision.contactList.count; i += 2)
+		for (uint32_t i = 0; i < collision.contactList.count; i += 2)
 		{
 			VertexPair elem;
 			elem.pointA = collision.contactList.points[i];
 			elem.pointB = collision.contactList.points[i + 1];
 
-			bool existed = false;
-			Vector2 localA = bodyA->toLocalPoint(elem.pointA);
-			Vector2 localB = bodyB->toLocalPoint(elem.pointB);
-			for (auto& contact : contactList)
+			const uint64_t id = collision.contactList.ids[i / 2];
+			const Vector2 localA = bodyA->toLocalPoint(elem.pointA);
+			const Vector2 localB = bodyB->toLocalPoint(elem.pointB);
+			ContactConstraintPoint ccp;
+			ccp.relation = relation;
+			uint32_t match = previous.count;
+			for (uint32_t j = 0; j < previous.count; ++j)
 			{
-				const bool isPointA = localA.fuzzyEqual(contact.localA, Constant::TrignometryEpsilon);
-				const bool isPointB = localB.fuzzyEqual(contact.localB, Constant::TrignometryEpsilon);
-				if (isPointA || isPointB || isRoundA || isRoundB)
+				if (!used[j] && previous[j].id == id)
 				{
-					//satisfy the condition, give the old accumulated value to new value
-					contact.localA = localA;
-					contact.localB = localB;
-					prepare(contact, elem, collision);
-					existed = true;
+					match = j;
 					break;
 				}
 			}
-			if (existed)
-				continue;
-
-			//no eligible contact, push new contact points
-			ContactConstraintPoint ccp;
+			//a vertex lying on a side plane of the reference face flips between being clipped and not,
+			//and its id with it. The point itself barely moved, so it is still found by position
+			if (match == previous.count)
+			{
+				for (uint32_t j = 0; j < previous.count; ++j)
+				{
+					if (!used[j] && (localA.fuzzyEqual(previous[j].localA, Constant::TrignometryEpsilon) ||
+						localB.fuzzyEqual(previous[j].localB, Constant::TrignometryEpsilon)))
+					{
+						match = j;
+						break;
+					}
+				}
+			}
+			if (match != previous.count)
+			{
+				ccp = previous[match];
+				used[match] = true;
+			}
+			ccp.id = id;
 			ccp.localA = localA;
 			ccp.localB = localB;
-			ccp.relation = relation;
 			prepare(ccp, elem, collision);
 			contactList.emplace_back(ccp);
 		}
@@ -563,34 +1007,57 @@ namespace Physics2D
 
 	void ContactMaintainer::clearInactivePoints()
 	{
-
-		for (auto&& iter : m_contactTable)
+		//backwards, so that the manifold swapped into an expired slot has already been compacted
+		for (size_t i = m_contactTable.size(); i-- > 0;)
 		{
-			auto& contactList = iter.second;
-			std::erase_if(contactList, [](const ContactConstraintPoint& ccp)
+			auto& contactList = m_contactTable[i];
+			uint32_t count = 0;
+			for (uint32_t j = 0; j < contactList.count; ++j)
+				if (contactList.points[j].active)
+					contactList.points[count++] = contactList.points[j];
+			contactList.count = count;
+			if (count != 0)
+				continue;
+
+			m_contactIndex.erase(contactList.relation);
+			if (i + 1 != m_contactTable.size())
 			{
-				return !ccp.active;
-			});
+				contactList = m_contactTable.back();
+				m_contactIndex.insert(contactList.relation, static_cast<Index>(i));
+			}
+			m_contactTable.pop_back();
 		}
-		std::erase_if(m_contactTable, [](const auto& item)
-		{
-			const auto& [key, value] = item;
-			return value.empty();
-		});
-
 	}
 
 	void ContactMaintainer::deactivateAllPoints()
 	{
-		for (auto iter = m_contactTable.begin(); iter != m_contactTable.end(); ++iter)
-		{
-			if (iter->second.empty() || !iter->second[0].active)
-				continue;
-
-			for (auto& ccp : iter->second)
+		for (auto& contactList : m_contactTable)
+			for (auto& ccp : contactList)
 				ccp.active = false;
-		}
+	}
+
+	bool ContactMaintainer::keepAlive(const Body::BodyPair::BodyPairID& relation)
+	{
+		ContactManifold* contactList = find(relation);
+		if (contactList == nullptr)
+			return false;
+		for (auto& ccp : *contactList)
+			ccp.active = true;
+		return true;
+	}
 
+	ContactManifold* ContactMaintainer::find(const Body::BodyPair::BodyPairID& relation)
+	{
+		const Index slot = m_contactIndex.find(relation);
+		return slot == ContactIndex::InvalidSlot ? nullptr : &m_contactTable[slot];
+	}
+
+	size_t ContactMaintainer::contactPointCount() const
+	{
+		size_t count = 0;
+		for (const auto& contactList : m_contactTable)
+			count += contactList.size();
+		return count;
 	}
 
 	void ContactMaintainer::prepare(ContactConstraintPoint& ccp, const VertexPair& pair, const Collision& collision)
@@ -637,6 +1104,11 @@ namespace Physics2D
 
 		//vcp.velocityBias = -vcp.penetration / 60.0f;
 		vcp.velocityBias = 0;
+		//a point that is still apart lets the bodies close the gap within the step, only the rest of the
+		//approaching velocity is removed. they stop short of touching, touching shapes have no distance normal
+		const real separation = (pair.pointA - pair.pointB).dot(vcp.normal) - Constant::SpeculativeGap;
+		if (m_speculativeDeltaTime > 0 && separation > 0)
+			vcp.velocityBias = vcp.normal * (separation / m_speculativeDeltaTime);
 
 		//accumulate inherited impulse
 		Vector2 impulse = vcp.accumulatedNormalImpulse * vcp.normal + vcp.accumulatedTangentImpulse * vcp.tangent;
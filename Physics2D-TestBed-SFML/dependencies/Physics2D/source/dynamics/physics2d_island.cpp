@@ -0,0 +1,265 @@
+#include "physics2d_island.h"
+
+#include <bit>
+
+namespace Physics2D
+{
+	namespace
+	{
+		constexpr Index InvalidIsland = std::numeric_limits<Index>::max();
+		constexpr size_t MaxColorCount = 64;
+
+		//a body that is not part of any island but still moves keeps the islands it touches awake
+		bool disturbs(Body* body)
+		{
+			return body != nullptr && body->type() != Body::BodyType::Static && body->kineticEnergy() > Constant::MinEnergy;
+		}
+	}
+
+	Container::Vector<Island>& IslandBuilder::islands()
+	{
+		return m_islands;
+	}
+
+	size_t IslandBuilder::awakeCount() const
+	{
+		return m_awakeCount;
+	}
+
+	Index IslandBuilder::find(Index index)
+	{
+		//path halving
+		while (m_parent[index] != index)
+		{
+			m_parent[index] = m_parent[m_parent[index]];
+			index = m_parent[index];
+		}
+		return index;
+	}
+
+	void IslandBuilder::unite(Index a, Index b)
+	{
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return;
+		//lower index wins so that the result does not depend on the order of the links
+		if (a < b)
+			m_parent[b] = a;
+		else
+			m_parent[a] = b;
+	}
+
+	bool IslandBuilder::linkable(Body* body)
+	{
+		return body->type() != Body::BodyType::Static && body->inverseMass() > 0.0f;
+	}
+
+	bool IslandBuilder::linkable(const BodyStore& store, const Index& index) const
+	{
+		return store.type[index] != Body::BodyType::Static && store.inverseMass[index] > 0.0f;
+	}
+
+	void IslandBuilder::build(PhysicsWorld& world, ContactMaintainer& maintainer)
+	{
+		BodyStore& store = world.bodyStore();
+		const Index count = static_cast<Index>(store.size());
+
+		m_parent.resize(count);
+		for (Index i = 0; i < count; ++i)
+			m_parent[i] = i;
+
+		for (auto& contactList : maintainer.m_contactTable)
+		{
+			if (contactList.empty() || !contactList[0].active)
+				continue;
+			const Index a = contactList[0].bodyA->storeIndex();
+			const Index b = contactList[0].bodyB->storeIndex();
+			if (linkable(store, a) && linkable(store, b))
+				unite(a, b);
+		}
+
+		for (auto&& joint : world.jointList())
+		{
+			if (!joint->active() || joint->bodyA() == nullptr || joint->bodyB() == nullptr)
+				continue;
+			const Index a = joint->bodyA()->storeIndex();
+			const Index b = joint->bodyB()->storeIndex();
+			if (linkable(store, a) && linkable(store, b))
+				unite(a, b);
+		}
+
+		//number the roots in store order and reuse the island storage of the last step
+		m_islandIndex.assign(count, InvalidIsland);
+		Index islandCount = 0;
+		for (Index i = 0; i < count; ++i)
+		{
+			if (!linkable(store, i))
+				continue;
+			const Index root = find(i);
+			if (m_islandIndex[root] == InvalidIsland)
+				m_islandIndex[root] = islandCount++;
+			m_islandIndex[i] = m_islandIndex[root];
+		}
+
+		m_islands.resize(islandCount);
+		for (auto& island : m_islands)
+		{
+			island.bodies.clear();
+			island.contacts.clear();
+			island.joints.clear();
+			island.sleep = world.enableSleep();
+		}
+
+		for (Index i = 0; i < count; ++i)
+			if (m_islandIndex[i] != InvalidIsland)
+				m_islands[m_islandIndex[i]].bodies.emplace_back(store.body[i]);
+
+		for (auto& contactList : maintainer.m_contactTable)
+		{
+			if (contactList.empty() || !contactList[0].active)
+				continue;
+			Body* bodyA = contactList[0].bodyA;
+			Body* bodyB = contactList[0].bodyB;
+			Index island = m_islandIndex[bodyA->storeIndex()];
+			Body* other = bodyB;
+			if (island == InvalidIsland)
+			{
+				island = m_islandIndex[bodyB->storeIndex()];
+				other = bodyA;
+			}
+			//neither body can move, nothing to solve
+			if (island == InvalidIsland)
+				continue;
+			m_islands[island].contacts.emplace_back(&contactList);
+			if (m_islandIndex[other->storeIndex()] == InvalidIsland && disturbs(other))
+				m_islands[island].sleep = false;
+		}
+
+		for (auto&& joint : world.jointList())
+		{
+			if (!joint->active() || joint->bodyA() == nullptr)
+				continue;
+			Body* bodyA = joint->bodyA();
+			Body* bodyB = joint->bodyB();
+			Index island = m_islandIndex[bodyA->storeIndex()];
+			Body* other = bodyB;
+			if (island == InvalidIsland && bodyB != nullptr)
+			{
+				island = m_islandIndex[bodyB->storeIndex()];
+				other = bodyA;
+			}
+			if (island == InvalidIsland)
+				continue;
+			m_islands[island].joints.emplace_back(joint.get());
+			if (other != nullptr && m_islandIndex[other->storeIndex()] == InvalidIsland && disturbs(other))
+				m_islands[island].sleep = false;
+		}
+
+		//an island sleeps only if all of its bodies may sleep, otherwise every body in it is woken
+		m_awakeCount = 0;
+		for (auto& island : m_islands)
+		{
+			for (Body* body : island.bodies)
+			{
+				if (!island.sleep)
+					break;
+				if (body->type() != Body::BodyType::Dynamic ||
+					(!body->sleep() && body->sleepCountdown() < Constant::SleepCountdown))
+					island.sleep = false;
+			}
+
+			for (Body* body : island.bodies)
+			{
+				if (island.sleep && !body->sleep())
+				{
+					body->setSleep(true);
+					body->velocity().clear();
+					body->angularVelocity() = 0.0f;
+				}
+				else if (!island.sleep && body->sleep())
+					body->setSleep(false);
+			}
+
+			if (!island.sleep)
+				++m_awakeCount;
+		}
+	}
+
+	void IslandBuilder::color(Island& island, BodyStore& store)
+	{
+		ConstraintColors& colors = island.colors;
+		for (auto& color : colors.contacts)
+			color.clear();
+		for (auto& color : colors.joints)
+			color.clear();
+		colors.contactOverflow.clear();
+		colors.jointOverflow.clear();
+		m_colorMask.assign(store.size(), 0);
+
+		//lowest color that none of the bodies has taken yet, MaxColorCount if all of them are taken
+		auto pick = [this](Body* bodyA, Body* bodyB)
+		{
+			uint64_t used = 0;
+			if (bodyA != nullptr)
+				used |= m_colorMask[bodyA->storeIndex()];
+			if (bodyB != nullptr)
+				used |= m_colorMask[bodyB->storeIndex()];
+			const size_t color = std::countr_zero(~used);
+			if (color < MaxColorCount)
+			{
+				if (bodyA != nullptr)
+					m_colorMask[bodyA->storeIndex()] |= uint64_t(1) << color;
+				if (bodyB != nullptr)
+					m_colorMask[bodyB->storeIndex()] |= uint64_t(1) << color;
+			}
+			return color;
+		};
+
+		//joints write both of their bodies whatever the mass, so every body counts
+		for (auto* joint : island.joints)
+		{
+			const size_t color = pick(joint->bodyA(), joint->bodyB());
+			if (color == MaxColorCount)
+			{
+				colors.jointOverflow.emplace_back(joint);
+				continue;
+			}
+			if (colors.joints.size() <= color)
+				colors.joints.resize(color + 1);
+			colors.joints[color].emplace_back(joint);
+		}
+
+		//joints and contacts are solved in separate passes, so contacts start over with fresh masks.
+		//contacts never write bodies without inverse mass and inertia, so the ground does not serialize them
+		for (auto* joint : island.joints)
+		{
+			if (joint->bodyA() != nullptr)
+				m_colorMask[joint->bodyA()->storeIndex()] = 0;
+			if (joint->bodyB() != nullptr)
+				m_colorMask[joint->bodyB()->storeIndex()] = 0;
+		}
+		auto written = [](Body* body) -> Body*
+		{
+			return body->inverseMass() != 0.0f || body->inverseInertia() != 0.0f ? body : nullptr;
+		};
+		for (auto* contactList : island.contacts)
+		{
+			const size_t color = pick(written(contactList->front().bodyA), written(contactList->front().bodyB));
+			if (color == MaxColorCount)
+			{
+				colors.contactOverflow.emplace_back(contactList);
+				continue;
+			}
+			if (colors.contacts.size() <= color)
+				colors.contacts.resize(color + 1);
+			colors.contacts[color].emplace_back(contactList);
+		}
+
+		//drop colors left over from a larger island of an earlier step
+		while (!colors.joints.empty() && colors.joints.back().empty())
+			colors.joints.pop_back();
+		while (!colors.contacts.empty() && colors.contacts.back().empty())
+			colors.contacts.pop_back();
+	}
+}
@@ -1,5 +1,430 @@
 #include "physics2d_solver.h"
+
 namespace Physics2D
 {
+	namespace
+	{
+		real generalizedInverseMass(Body* body, const Vector2& r, const Vector2& direction)
+		{
+			const real rn = r.cross(direction);
+			return body->inverseMass() + body->inverseInertia() * rn * rn;
+		}
+
+		//moves the anchor of bodyA by correction relative to the anchor of bodyB, split by the inverse masses.
+		//returns the multiplier of the projection
+		real applyPositionCorrection(Body* bodyA, Body* bodyB, const Vector2& correction, const Vector2& ra,
+		                             const Vector2& rb, const real& compliance)
+		{
+			const real c = correction.length();
+			if (realEqual(c, 0.0f))
+				return 0;
+			const Vector2 n = correction / c;
+			const real w = generalizedInverseMass(bodyA, ra, n) + generalizedInverseMass(bodyB, rb, n);
+			if (w + compliance == 0.0f)
+				return 0;
+
+			const real lambda = c / (w + compliance);
+			bodyA->applyPositionImpulse(lambda * n, ra);
+			bodyB->applyPositionImpulse(-lambda * n, rb);
+			return lambda;
+		}
+
+		//turns bodyA by angle relative to bodyB
+		void applyAngularCorrection(Body* bodyA, Body* bodyB, const real& angle, const real& compliance)
+		{
+			const real w = bodyA->inverseInertia() + bodyB->inverseInertia();
+			if (w + compliance == 0.0f)
+				return;
+			const real lambda = angle / (w + compliance);
+			//static and kinematic bodies are shared between islands, they must not be written from several threads
+			if (bodyA->inverseInertia() != 0.0f)
+				bodyA->rotation() += bodyA->inverseInertia() * lambda;
+			if (bodyB->inverseInertia() != 0.0f)
+				bodyB->rotation() -= bodyB->inverseInertia() * lambda;
+		}
+
+		//mixed linear complementarity of two contact points, lambda >= 0 and c - k * lambda <= 0 with equality where
+		//lambda > 0. A bound point is solved as an equality whatever the sign of its lambda. The cases are tried in
+		//turn like the block solver of ContactMaintainer
+		void solveBlock(const real& k11, const real& k12, const real& k22, const real& c1, const real& c2,
+		                const bool& bound1, const bool& bound2, real& lambda1, real& lambda2)
+		{
+			lambda1 = 0;
+			lambda2 = 0;
+
+			//both points, unless the matrix is too close to singular as in ContactMaintainer
+			const real det = k11 * k22 - k12 * k12;
+			if (k11 * k11 < 1000.0f * det)
+			{
+				const real x1 = (k22 * c1 - k12 * c2) / det;
+				const real x2 = (k11 * c2 - k12 * c1) / det;
+				if ((x1 >= 0 || bound1) && (x2 >= 0 || bound2))
+				{
+					lambda1 = x1;
+					lambda2 = x2;
+					return;
+				}
+			}
+
+			//only one of them, the other ends up apart. the deeper point is the fallback of a degenerate pair
+			const real x1 = k11 > 0 ? c1 / k11 : 0;
+			const real x2 = k22 > 0 ? c2 / k22 : 0;
+			if (!bound2 && (x1 >= 0 || bound1) && c2 - k12 * x1 <= 0)
+				lambda1 = x1;
+			else if (!bound1 && (x2 >= 0 || bound2) && c1 - k12 * x2 <= 0)
+				lambda2 = x2;
+			else if (!bound1 && !bound2 && c1 <= 0 && c2 <= 0)
+				return;
+			else if (c1 >= c2)
+				lambda1 = bound1 ? x1 : Math::max(x1, 0);
+			else
+				lambda2 = bound2 ? x2 : Math::max(x2, 0);
+		}
+
+		//effective mass matrix of the normals of two contact points
+		void blockMass(Body* bodyA, Body* bodyB, const Vector2* ra, const Vector2* rb, const Vector2& normal,
+		               real& k11, real& k12, real& k22)
+		{
+			const real rnA1 = ra[0].cross(normal);
+			const real rnA2 = ra[1].cross(normal);
+			const real rnB1 = rb[0].cross(normal);
+			const real rnB2 = rb[1].cross(normal);
+			const real im = bodyA->inverseMass() + bodyB->inverseMass();
+			k11 = im + bodyA->inverseInertia() * rnA1 * rnA1 + bodyB->inverseInertia() * rnB1 * rnB1;
+			k22 = im + bodyA->inverseInertia() * rnA2 * rnA2 + bodyB->inverseInertia() * rnB2 * rnB2;
+			k12 = im + bodyA->inverseInertia() * rnA1 * rnA2 + bodyB->inverseInertia() * rnB1 * rnB2;
+		}
+
+		//normal multipliers of the points of a manifold that take part, two of them are solved together
+		void solveNormals(Body* bodyA, Body* bodyB, const Vector2* ra, const Vector2* rb, const Vector2& normal,
+		                  const real* c, const bool* in, const bool* bound, size_t count, const real& compliance,
+		                  real* lambda)
+		{
+			if (count == 2 && in[0] && in[1])
+			{
+				real k11, k12, k22;
+				blockMass(bodyA, bodyB, ra, rb, normal, k11, k12, k22);
+				solveBlock(k11 + compliance, k12, k22 + compliance, c[0], c[1], bound[0], bound[1], lambda[0], lambda[1]);
+				return;
+			}
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (!in[i] || (c[i] <= 0 && !bound[i]))
+					continue;
+				const real k = generalizedInverseMass(bodyA, ra[i], normal) + generalizedInverseMass(bodyB, rb[i], normal) +
+					compliance;
+				if (k > 0)
+					lambda[i] = c[i] / k;
+			}
+		}
+
+		//anchors of bodyA and bodyB are pulled onto each other
+		void solvePoint(Body* bodyA, Body* bodyB, const Vector2& localPointA, const Vector2& localPointB,
+		                const real& compliance)
+		{
+			const Vector2 pa = bodyA->toWorldPoint(localPointA);
+			const Vector2 pb = bodyB->toWorldPoint(localPointB);
+			applyPositionCorrection(bodyA, bodyB, pb - pa, pa - bodyA->position(), pb - bodyB->position(), compliance);
+		}
+	}
+
+	void XPBDSolver::beginSubStep(ContactMaintainer& maintainer, BodyStore& store, const Vector2& gravity,
+	                              const real& h)
+	{
+		m_position.assign(store.position.begin(), store.position.end());
+		m_rotation.assign(store.rotation.begin(), store.rotation.end());
+
+		m_table = maintainer.m_contactTable.data();
+		m_points.resize(maintainer.m_contactTable.size() * ContactManifold::Capacity);
+		m_slop = maintainer.m_maxPenetration;
+		m_maxCorrection = maintainer.m_maxPushVelocity * h;
+		m_restitutionThreshold = 2.0f * gravity.length() * h;
+	}
+
+	XPBDSolver::PointState* XPBDSolver::stateOf(const ContactManifold& contactList)
+	{
+		return m_points.data() + (&contactList - m_table) * ContactManifold::Capacity;
+	}
+
+	void XPBDSolver::solvePosition(ContactManifold& contactList, const real& h)
+	{
+		if (contactList.empty())
+			return;
+
+		Body* bodyA = contactList.front().bodyA;
+		Body* bodyB = contactList.front().bodyB;
+		const real compliance = m_contactCompliance / (h * h);
+
+		PointState* state = stateOf(contactList);
+		Vector2 ra[ContactManifold::Capacity];
+		Vector2 rb[ContactManifold::Capacity];
+		//penetration past the slop, points that are apart or inactive are never pushed. a deep one is taken out over
+		//several sub-steps, all at once it would leave the bodies flying apart
+		real c[ContactManifold::Capacity] = {};
+		bool active[ContactManifold::Capacity] = {};
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			auto& ccp = contactList[i];
+			state[i] = PointState();
+			active[i] = ccp.active;
+			if (!ccp.active)
+				continue;
+
+			//the normal and the anchors stay those of the detection
+			auto& vcp = ccp.vcp;
+			const Vector2 pa = bodyA->toWorldPoint(vcp.localA);
+			const Vector2 pb = bodyB->toWorldPoint(vcp.localB);
+			ra[i] = pa - bodyA->position();
+			rb[i] = pb - bodyB->position();
+			const real penetration = (pb - pa).dot(vcp.normal);
+			c[i] = Math::min(penetration - m_slop, m_maxCorrection);
+			state[i].touching = penetration > 0;
+
+			//velocity the sub-step started with, restitution is measured against it
+			const Vector2 va = bodyA->velocity() + Vector2::crossProduct(bodyA->angularVelocity(), ra[i]);
+			const Vector2 vb = bodyB->velocity() + Vector2::crossProduct(bodyB->angularVelocity(), rb[i]);
+			state[i].normalVelocity = vcp.normal.dot(va - vb);
+		}
+
+		//two points are pushed out together, one after the other would leave the bodies tilted by up to the slop
+		const Vector2& normal = contactList.front().vcp.normal;
+		const bool bound[ContactManifold::Capacity] = {};
+		real lambda[ContactManifold::Capacity] = {};
+		solveNormals(bodyA, bodyB, ra, rb, normal, c, active, bound, contactList.size(), compliance, lambda);
+
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			if (lambda[i] <= 0)
+				continue;
+			const Vector2 impulse = lambda[i] * normal;
+			bodyA->applyPositionImpulse(impulse, ra[i]);
+			bodyB->applyPositionImpulse(-impulse, rb[i]);
+			state[i].normalLambda = lambda[i];
+		}
+
+		//friction acts once at the center of the pushed points, weighted by how hard each was pushed. point by point
+		//the second one would undo the turn the first one left
+		Vector2 localA;
+		Vector2 localB;
+		real normalLambda = 0;
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			const auto& vcp = contactList[i].vcp;
+			const real pushed = state[i].normalLambda;
+			if (pushed <= 0)
+				continue;
+			localA += pushed * vcp.localA;
+			localB += pushed * vcp.localB;
+			normalLambda += pushed;
+		}
+		if (normalLambda < Constant::GeometryEpsilon)
+			return;
+
+		//static friction pulls the anchors of the detection back over each other along the tangent, unless that
+		//takes more than the friction cone allows. measured from the anchors, slip that one sub-step leaves is
+		//taken back by the next
+		localA /= normalLambda;
+		localB /= normalLambda;
+		const Vector2& tangent = contactList.front().vcp.tangent;
+		const Vector2 pa = bodyA->toWorldPoint(localA);
+		const Vector2 pb = bodyB->toWorldPoint(localB);
+		const Vector2 rA = pa - bodyA->position();
+		const Vector2 rB = pb - bodyB->position();
+		const real slip = (pa - pb).dot(tangent);
+
+		const real w = generalizedInverseMass(bodyA, rA, tangent) + generalizedInverseMass(bodyB, rB, tangent) + compliance;
+		if (w == 0.0f)
+			return;
+		const real tangentLambda = slip / w;
+		if (Math::abs(tangentLambda) >= contactList.front().friction * normalLambda)
+			return;
+		bodyA->applyPositionImpulse(-tangentLambda * tangent, rA);
+		bodyB->applyPositionImpulse(tangentLambda * tangent, rB);
+	}
+
+	void XPBDSolver::solvePosition(Joint* joint, const real& h)
+	{
+		if (!projectable(joint))
+		{
+			joint->solvePosition(h);
+			return;
+		}
+
+		const real compliance = m_jointCompliance / (h * h);
+		switch (joint->type())
+		{
+		case JointType::Revolute:
+		{
+			auto& primitive = static_cast<RevoluteJoint*>(joint)->primitive();
+			Body* bodyA = primitive.bodyA;
+			Body* bodyB = primitive.bodyB;
+			if (primitive.angularLimit)
+			{
+				const real angle = bodyA->rotation() - bodyB->rotation() - primitive.referenceAngle;
+				if (angle < primitive.lowerAngle)
+					applyAngularCorrection(bodyA, bodyB, primitive.lowerAngle - angle, compliance);
+				else if (angle > primitive.upperAngle)
+					applyAngularCorrection(bodyA, bodyB, primitive.upperAngle - angle, compliance);
+			}
+			solvePoint(bodyA, bodyB, primitive.localPointA, primitive.localPointB, compliance);
+			break;
+		}
+		case JointType::Weld:
+		{
+			const auto primitive = static_cast<WeldJoint*>(joint)->primitive();
+			Body* bodyA = primitive.bodyA;
+			Body* bodyB = primitive.bodyB;
+			applyAngularCorrection(bodyA, bodyB,
+			                       -(bodyA->rotation() - bodyB->rotation() - primitive.referenceAngle), compliance);
+			solvePoint(bodyA, bodyB, primitive.localPointA, primitive.localPointB, compliance);
+			break;
+		}
+		case JointType::Distance:
+		{
+			auto& primitive = static_cast<DistanceJoint*>(joint)->primitive();
+			Body* bodyA = primitive.bodyA;
+			Body* bodyB = primitive.bodyB;
+			const Vector2 pa = bodyA->toWorldPoint(primitive.localPointA);
+			const Vector2 pb = bodyB->toWorldPoint(primitive.localPointB);
+			const Vector2 error = pa - pb;
+			const real length = error.length();
+			if (realEqual(length, 0.0f))
+				break;
+			const real target = Math::clamp(length, primitive.minDistance, primitive.maxDistance);
+			if (target == length)
+				break;
+			applyPositionCorrection(bodyA, bodyB, (target - length) / length * error, pa - bodyA->position(),
+			                        pb - bodyB->position(), compliance);
+			break;
+		}
+		case JointType::Rotation:
+		{
+			const auto primitive = static_cast<RotationJoint*>(joint)->primitive();
+			Body* bodyA = primitive.bodyA;
+			Body* bodyB = primitive.bodyB;
+			applyAngularCorrection(bodyA, bodyB,
+			                       -(bodyA->rotation() - bodyB->rotation() - primitive.referenceRotation), compliance);
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void XPBDSolver::updateVelocities(BodyStore& store, const real& h)
+	{
+		const real inverseH = 1.0f / h;
+		for (size_t i = 0; i < store.size(); ++i)
+		{
+			if ((store.type[i] != Body::BodyType::Dynamic && store.type[i] != Body::BodyType::Bullet) || store.sleep[i])
+				continue;
+			store.velocity[i] = (store.position[i] - m_position[i]) * inverseH;
+			store.angularVelocity[i] = (store.rotation[i] - m_rotation[i]) * inverseH;
+		}
+	}
+
+	void XPBDSolver::solveVelocity(ContactManifold& contactList, const real& h)
+	{
+		if (contactList.empty())
+			return;
+
+		Body* bodyA = contactList.front().bodyA;
+		Body* bodyB = contactList.front().bodyB;
+		const Vector2& normal = contactList.front().vcp.normal;
+		PointState* state = stateOf(contactList);
+		Vector2 ra[ContactManifold::Capacity];
+		Vector2 rb[ContactManifold::Capacity];
+		//normal velocity still missing to reach the target of every point. points pushed out in this sub-step are held
+		//at the target both ways, the velocity a deep push leaves behind is taken back
+		real b[ContactManifold::Capacity] = {};
+		bool touching[ContactManifold::Capacity] = {};
+		bool bound[ContactManifold::Capacity] = {};
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			auto& ccp = contactList[i];
+			auto& vcp = ccp.vcp;
+			//the multipliers are positional, warm starting the next detection with them would push twice
+			vcp.accumulatedNormalImpulse = 0;
+			vcp.accumulatedTangentImpulse = 0;
+
+			const auto& point = state[i];
+			if (!point.touching)
+				continue;
+
+			ra[i] = bodyA->toWorldPoint(vcp.localA) - bodyA->position();
+			rb[i] = bodyB->toWorldPoint(vcp.localB) - bodyB->position();
+			const Vector2 va = bodyA->velocity() + Vector2::crossProduct(bodyA->angularVelocity(), ra[i]);
+			const Vector2 vb = bodyB->velocity() + Vector2::crossProduct(bodyB->angularVelocity(), rb[i]);
+			//only points that were pushed bounce, slow approaches come from gravity alone within the sub-step
+			const real restitution = point.normalLambda <= 0 ||
+				Math::abs(point.normalVelocity) <= m_restitutionThreshold ? 0.0f : vcp.restitution;
+			b[i] = Math::max(-restitution * point.normalVelocity, 0) - normal.dot(va - vb);
+			touching[i] = true;
+			bound[i] = point.normalLambda > 0;
+		}
+
+		real lambda[ContactManifold::Capacity] = {};
+		solveNormals(bodyA, bodyB, ra, rb, normal, b, touching, bound, contactList.size(), 0, lambda);
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			if (lambda[i] == 0.0f)
+				continue;
+			bodyA->applyImpulse(lambda[i] * normal, ra[i]);
+			bodyB->applyImpulse(-lambda[i] * normal, rb[i]);
+		}
+
+		//dynamic friction at the center of the points, bounded by their normal impulse over the sub-step. that is the
+		//push of the projection and the impulse above, resting points sit within the slop and only have the latter
+		Vector2 rA;
+		Vector2 rB;
+		real normalImpulse = 0;
+		for (size_t i = 0; i < contactList.size(); ++i)
+		{
+			const real pushed = state[i].normalLambda / h + lambda[i];
+			if (pushed <= 0)
+				continue;
+			rA += pushed * ra[i];
+			rB += pushed * rb[i];
+			normalImpulse += pushed;
+		}
+		if (normalImpulse < Constant::GeometryEpsilon)
+			return;
+
+		rA /= normalImpulse;
+		rB /= normalImpulse;
+		const Vector2& tangent = contactList.front().vcp.tangent;
+		const Vector2 va = bodyA->velocity() + Vector2::crossProduct(bodyA->angularVelocity(), rA);
+		const Vector2 vb = bodyB->velocity() + Vector2::crossProduct(bodyB->angularVelocity(), rB);
+		const real w = generalizedInverseMass(bodyA, rA, tangent) + generalizedInverseMass(bodyB, rB, tangent);
+		if (w == 0.0f)
+			return;
+		const real maxImpulse = contactList.front().friction * normalImpulse;
+		const real impulse = Math::clamp(-tangent.dot(va - vb) / w, -maxImpulse, maxImpulse);
+		bodyA->applyImpulse(impulse * tangent, rA);
+		bodyB->applyImpulse(-impulse * tangent, rB);
+	}
+
+	void XPBDSolver::solveVelocity(Joint* joint, const real& h)
+	{
+		if (projectable(joint))
+			return;
+		joint->prepare(h);
+		joint->solveVelocity(h);
+	}
 
-}
\ No newline at end of file
+	bool XPBDSolver::projectable(Joint* joint)
+	{
+		if (joint->bodyA() == nullptr || joint->bodyB() == nullptr)
+			return false;
+		switch (joint->type())
+		{
+		case JointType::Revolute:
+		case JointType::Weld:
+		case JointType::Distance:
+		case JointType::Rotation:
+			return true;
+		default:
+			return false;
+		}
+	}
+}
@@ -1,7 +1,165 @@
 #include "physics2d_system.h"
-#include "physics2d_system.h"
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include <utility>
 namespace Physics2D
 {
+    namespace
+    {
+        using ProfileClock = std::chrono::steady_clock;
+
+        bool isFrozen(Body* body)
+        {
+            return body->sleep() || body->type() == Body::BodyType::Static;
+        }
+
+        //smallest range of one color handed to a worker
+        constexpr size_t ColorGrainSize = 16;
+        //smallest number of broadphase pairs handed to a worker
+        constexpr size_t PairGrainSize = 64;
+        //a toi sub-step only holds a few contacts, so it pushes them apart harder and iterates them longer
+        //than the step does
+        constexpr int TOIIterations = 20;
+        constexpr real TOIBiasFactor = 0.75f;
+
+        //colors one after another, the constraints of a color in parallel, then the overflow on this thread.
+        //without a pool everything runs on this thread
+        template <typename Constraint, typename Function>
+        void forEachColor(ThreadPool* pool, Container::Vector<Container::Vector<Constraint>>& colors,
+                          const Function& function)
+        {
+            for (auto& color : colors)
+            {
+                if (pool == nullptr)
+                {
+                    for (auto& constraint : color)
+                        function(constraint);
+                    continue;
+                }
+                pool->parallelFor(color.size(), ColorGrainSize, [&](size_t begin, size_t end)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                        function(color[i]);
+                });
+            }
+        }
+
+        template <typename Constraint, typename Function>
+        void forEachColor(ThreadPool* pool, Container::Vector<Container::Vector<Constraint>>& colors,
+                          Container::Vector<Constraint>& overflow, const Function& function)
+        {
+            forEachColor(pool, colors, function);
+            for (auto& constraint : overflow)
+                function(constraint);
+        }
+
+        //neither body moved since the last detection of the pair, see Body::transformStamp
+        bool unchanged(const CollisionCache& cache, Body* bodyA, Body* bodyB)
+        {
+            return cache.detected && cache.transformStamp[0] == bodyA->transformStamp() &&
+                cache.transformStamp[1] == bodyB->transformStamp();
+        }
+
+        //furthest two bodies can close on each other within dt, from their linear velocities and the speed
+        //rotation gives to the furthest point of their shapes
+        real closingDistance(Body* bodyA, Body* bodyB, const real& dt)
+        {
+            const CCD::Sweep sweepA = CCD::Sweep::fromBody(bodyA);
+            const CCD::Sweep sweepB = CCD::Sweep::fromBody(bodyB);
+            return ((sweepA.velocity - sweepB.velocity).length() + Math::abs(sweepA.angularVelocity) * sweepA.radius +
+                Math::abs(sweepB.angularVelocity) * sweepB.radius) * dt;
+        }
+
+        //how far the bodies can close when either is stopped by a third body within the step, as a falling stack is
+        //when its bottom lands. bodies that move together close nothing by closingDistance
+        real travelDistance(Body* bodyA, Body* bodyB, const real& dt)
+        {
+            const CCD::Sweep sweepA = CCD::Sweep::fromBody(bodyA);
+            const CCD::Sweep sweepB = CCD::Sweep::fromBody(bodyB);
+            return (sweepA.velocity.length() + sweepB.velocity.length() + Math::abs(sweepA.angularVelocity) * sweepA.radius +
+                Math::abs(sweepB.angularVelocity) * sweepB.radius) * dt;
+        }
+
+        ShapePrimitive primitiveOf(Body* body)
+        {
+            ShapePrimitive primitive;
+            primitive.shape = body->shape();
+            primitive.transform.setRotation(body->rotation(), body->rotationMatrix());
+            primitive.transform.position = body->position();
+            return primitive;
+        }
+
+        //the pairs of [begin, end) that are about to be detected go through the batched gjk four at a time,
+        //cache.rejected marks the ones it proved apart. Pairs that touched in their last detection most likely
+        //still do and go straight to contact generation
+        void rejectSeparated(const Container::Vector<std::pair<Body*, Body*>>& pairs,
+                             const Container::Vector<CollisionCache*>& caches, size_t begin, size_t end)
+        {
+            GjkBatch batch;
+            CollisionCache* lanes[GjkBatch::LaneCount];
+            bool separated[GjkBatch::LaneCount];
+            auto flush = [&]
+            {
+                Narrowphase::gjkSeparated(batch, separated);
+                for (size_t lane = 0; lane < batch.size; ++lane)
+                    lanes[lane]->rejected = separated[lane];
+                batch.clear();
+            };
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& [bodyA, bodyB] = pairs[i];
+                CollisionCache& cache = *caches[i];
+                cache.rejected = false;
+                if ((isFrozen(bodyA) && isFrozen(bodyB)) || cache.colliding || unchanged(cache, bodyA, bodyB))
+                    continue;
+                if (!batch.add(primitiveOf(bodyA), primitiveOf(bodyB)))
+                    continue;
+                lanes[batch.size - 1] = &cache;
+                if (batch.size == GjkBatch::LaneCount)
+                    flush();
+            }
+            if (batch.size > 0)
+                flush();
+        }
+
+        //straight motion of a body from its pose at time on, over the rest of the step
+        struct BodyMotion
+        {
+            real time = 0;
+            Vector2 position;
+            real rotation = 0;
+            Vector2 velocity;
+            real angularVelocity = 0;
+        };
+
+        struct TOIEvent
+        {
+            real toi = 0;
+            //the query the event came from, so that the bodies are placed exactly where it found the contact
+            real start = 0;
+            real offset = 0;
+            Index bullet = 0;
+            Body* other = nullptr;
+            uint32_t version = 0;
+
+            bool operator>(const TOIEvent& rhs) const
+            {
+                return toi > rhs.toi;
+            }
+        };
+
+        //milliseconds since start, then restart the lap
+        double lap(ProfileClock::time_point& start)
+        {
+            const auto now = ProfileClock::now();
+            const double elapsed = std::chrono::duration<double, std::milli>(now - start).count();
+            start = now;
+            return elapsed;
+        }
+    }
+
     int& PhysicsSystem::positionIteration()
     {
         return m_positionIteration;
@@ -57,23 +215,126 @@ namespace Physics2D
         return m_grid;
     }
 
+    IslandBuilder& PhysicsSystem::islandBuilder()
+    {
+        return m_islandBuilder;
+    }
+
+    bool& PhysicsSystem::parallelSolve()
+    {
+        return m_parallelSolve;
+    }
+
+    ThreadPool& PhysicsSystem::threadPool()
+    {
+        return m_threadPool;
+    }
+
+    size_t& PhysicsSystem::coloringThreshold()
+    {
+        return m_coloringThreshold;
+    }
+
+    bool& PhysicsSystem::batchedRejection()
+    {
+        return m_batchedRejection;
+    }
+
+    bool& PhysicsSystem::analyticContacts()
+    {
+        return m_analyticContacts;
+    }
+
+    bool& PhysicsSystem::typedKernels()
+    {
+        return m_typedKernels;
+    }
+
+    bool& PhysicsSystem::speculativeContacts()
+    {
+        return m_speculativeContacts;
+    }
+
+    bool& PhysicsSystem::softStep()
+    {
+        return m_softStep;
+    }
+
+    int& PhysicsSystem::subStepCount()
+    {
+        return m_subStepCount;
+    }
+
+    bool& PhysicsSystem::xpbd()
+    {
+        return m_xpbd;
+    }
+
+    XPBDSolver& PhysicsSystem::xpbdSolver()
+    {
+        return m_xpbdSolver;
+    }
+
+    const StepProfile& PhysicsSystem::profile() const
+    {
+        return m_profile;
+    }
+
+    Container::Vector<StepProfile> PhysicsSystem::profileHistory() const
+    {
+        Container::Vector<StepProfile> history;
+        history.reserve(m_profileHistory.size());
+        for (size_t i = 0; i < m_profileHistory.size(); ++i)
+            history.emplace_back(m_profileHistory[(m_profileHistoryHead + i) % m_profileHistory.size()]);
+        return history;
+    }
+
+    void PhysicsSystem::recordProfile()
+    {
+        if (m_profileHistory.size() < Constant::ProfileHistoryCount)
+        {
+            m_profileHistory.emplace_back(m_profile);
+            return;
+        }
+        m_profileHistory[m_profileHistoryHead] = m_profile;
+        m_profileHistoryHead = (m_profileHistoryHead + 1) % m_profileHistory.size();
+    }
+
     void PhysicsSystem::step(const real &dt)
     {
         //updateTree();
         //updateGrid();
         
+        m_profile = StepProfile();
+        const auto start = ProfileClock::now();
+
+        //bullets take the step with everything else, then the toi queue pulls them back to their impacts
+        auto timer = start;
+        collectBullets();
+        m_profile.ccd += lap(timer);
+
+        solve(dt);
+
+        timer = ProfileClock::now();
+        updateTree(dt);
+        m_profile.updateTree += lap(timer);
 
-        //solve ccd first, then solve normal case.
-        if(!solveCCD(dt))
-            solve(dt);
+        solveCCD(dt);
 
-        updateTree();
+        m_profile.total = std::chrono::duration<double, std::milli>(ProfileClock::now() - start).count();
+        recordProfile();
     }
-    void PhysicsSystem::updateTree()
+    void PhysicsSystem::updateTree(const real& dt)
     {
         //bvh
+        const bool speculative = m_speculativeContacts || m_xpbd;
         for (const auto& elem : m_world.bodyList())
-            m_tree.update(elem.get());
+        {
+            if (speculative)
+                m_tree.update(elem.get(), elem->velocity() * dt);
+            else
+                m_tree.update(elem.get());
+        }
     }
 
     void PhysicsSystem::updateGrid()
@@ -81,44 +342,189 @@ namespace Physics2D
         m_grid.updateAll();
     }
 
-    bool PhysicsSystem::solveCCD(const real& dt)
+    void PhysicsSystem::collectBullets()
     {
-        Container::Vector<Body*> bullets;
+        m_bullets.clear();
         for (const auto& body : m_world.bodyList())
-            if (body->type() == Body::BodyType::Bullet)
-                bullets.emplace_back(body.get());
-
-        for (auto& bullet : bullets)
         {
             //check bullet velocity threshold
-            if (bullet->velocity().lengthSquare() < Constant::CCDMinVelocity && bullet->angularVelocity() < Constant::CCDMinVelocity)
+            if (body->type() == Body::BodyType::Bullet &&
+                !(body->velocity().lengthSquare() < Constant::CCDMinVelocity && body->angularVelocity() < Constant::CCDMinVelocity))
+                m_bullets.emplace_back(body.get());
+        }
+        if (m_bullets.empty())
+            return;
+        m_stepPosition = m_world.bodyStore().position;
+        m_stepRotation = m_world.bodyStore().rotation;
+    }
+
+    void PhysicsSystem::solveCCD(const real& dt)
+    {
+        if (m_bullets.empty())
+            return;
+        auto timer = ProfileClock::now();
+
+        //every body went on a straight line from its pose at the start of the step to where the step left it,
+        //bodies resolved in a sub-step go on from the pose they had at that impact
+        Container::Map<Body*, BodyMotion> resolved;
+        auto motionOf = [&](Body* body)
+        {
+            if (auto iter = resolved.find(body); iter != resolved.end())
+                return iter->second;
+            const Index index = body->storeIndex();
+            BodyMotion motion;
+            motion.position = m_stepPosition[index];
+            motion.rotation = m_stepRotation[index];
+            motion.velocity = (body->position() - motion.position) / dt;
+            motion.angularVelocity = (body->rotation() - motion.rotation) / dt;
+            return motion;
+        };
+        auto sweepAt = [&](Body* body, const real& time)
+        {
+            const BodyMotion motion = motionOf(body);
+            CCD::Sweep sweep = CCD::Sweep::fromBody(body);
+            sweep.position = motion.position + motion.velocity * (time - motion.time);
+            sweep.rotation = motion.rotation + motion.angularVelocity * (time - motion.time);
+            sweep.velocity = motion.velocity;
+            sweep.angularVelocity = motion.angularVelocity;
+            return sweep;
+        };
+
+        //an event is stale once its bullet has been looked at again, the version tells them apart
+        std::priority_queue<TOIEvent, Container::Vector<TOIEvent>, std::greater<>> events;
+        Container::Vector<uint32_t> versions(m_bullets.size(), 0);
+        Container::Vector<uint32_t> subSteps(m_bullets.size(), 0);
+        //bodies a bullet knocked fast enough, they only look for static bodies as they are no bullets themselves
+        Container::Vector<bool> struck(m_bullets.size(), false);
+        auto schedule = [&](Index bullet, const real& time)
+        {
+            ++versions[bullet];
+            const real remaining = dt - time;
+            if (remaining <= 0 || subSteps[bullet] >= Constant::CCDMaxSubSteps)
+                return;
+            Body* body = m_bullets[bullet];
+            const CCD::Sweep sweep = sweepAt(body, time);
+            std::optional<TOIEvent> earliest;
+            for (Body* other : m_tree.query(sweep.aabb(remaining)))
+            {
+                //bullets pass through each other, as in the discrete step
+                if (other == body || other->type() == Body::BodyType::Bullet)
+                    continue;
+                if (struck[bullet] && other->type() != Body::BodyType::Static)
+                    continue;
+                const auto toi = CCD::timeOfImpact(sweepAt(other, time), sweep, remaining, &m_profile.toiQueryCount);
+                if (toi.has_value() && (!earliest.has_value() || time + toi.value() < earliest->toi))
+                    earliest = TOIEvent{time + toi.value(), time, toi.value(), bullet, other, versions[bullet]};
+            }
+            if (earliest.has_value())
+                events.push(earliest.value());
+        };
+
+        for (Index i = 0; i < m_bullets.size(); ++i)
+            schedule(i, 0);
+
+        //the pair leaves the sub-step a little apart, so that looking again from the impact does not start overlapped
+        m_toiMaintainer.m_maxPenetration = -Constant::CCDPenetration;
+        m_toiMaintainer.m_biasFactor = TOIBiasFactor;
+        m_toiMaintainer.m_velocityBlockSolver = m_maintainer.m_velocityBlockSolver;
+        m_toiMaintainer.m_positionBlockSolver = m_maintainer.m_positionBlockSolver;
+
+        while (!events.empty())
+        {
+            const TOIEvent event = events.top();
+            events.pop();
+            if (event.version != versions[event.bullet])
                 continue;
-            auto potentials = CCD::query(m_tree, bullet, dt);
-            if (potentials.has_value())
+
+            Body* bullet = m_bullets[event.bullet];
+            Body* other = event.other;
+            const real remaining = dt - event.toi;
+            ++subSteps[event.bullet];
+
+            //both bodies go back to the time of impact and are solved alone for the rest of the step
+            Body* bodies[2] = {bullet, other};
+            for (Body* body : bodies)
+            {
+                const ShapePrimitive pose = sweepAt(body, event.start).at(event.offset);
+                body->position() = pose.transform.position;
+                body->rotation() = pose.transform.rotation;
+            }
+            const Collision collision = Detector::detect(bullet, other, nullptr, m_analyticContacts, m_typedKernels);
+            if (!collision.isColliding)
             {
-                auto finals = CCD::earliestTOI(potentials.value());
-                if (finals.has_value())
+                //the advancement ran out of iterations short of the impact, go on looking from there
+                for (Body* body : bodies)
                 {
-                    //if toi still exist, just keep solving them until the sum of toi is greater than dt
-                    real toi = finals.value();
-                    updateTree();
-                    solve(toi);
-                    real iterVel = bullet->velocity().length() / 50;
-                    real iterAng = Math::abs(bullet->angularVelocity()) / 10;
-                    real iterReal = Math::max(real(Constant::CCDMaxIterations), Math::max(iterVel, iterAng));
-                    iterReal = std::ceil(iterReal);
-                	real ddt = (dt - toi) / iterReal;
-                    for (int i = 0; i <= int(iterReal); ++i) {
-                        updateTree();
-                        solve(ddt);
-                    }
-                    //return solved
-                    return true;
+                    const CCD::Sweep sweep = sweepAt(body, dt);
+                    body->position() = sweep.position;
+                    body->rotation() = sweep.rotation;
+                }
+                schedule(event.bullet, event.toi);
+                continue;
+            }
+
+            bullet->setSleep(false);
+            other->setSleep(false);
+            m_toiMaintainer.clearAll();
+            m_toiMaintainer.add(collision);
+            //a body pinned to static ones passes the impact on to them instead of being pushed into them
+            if (other->type() == Body::BodyType::Dynamic)
+            {
+                for (Body* body : m_tree.query(AABB::fromBody(other)))
+                {
+                    if (body->type() != Body::BodyType::Static)
+                        continue;
+                    const Collision pin = Detector::detect(other, body, nullptr, m_analyticContacts, m_typedKernels);
+                    if (pin.isColliding)
+                        m_toiMaintainer.add(pin);
+                }
+            }
+            for (int i = 0; i < TOIIterations; ++i)
+                m_toiMaintainer.solvePosition(remaining);
+            for (int i = 0; i < TOIIterations; ++i)
+                m_toiMaintainer.solveVelocity(remaining);
+            m_toiMaintainer.solveRestitution(remaining);
+
+            //the rest of the step goes on from the separated pose at the new velocity
+            for (Body* body : bodies)
+            {
+                BodyMotion motion;
+                motion.time = event.toi;
+                motion.position = body->position();
+                motion.rotation = body->rotation();
+                motion.velocity = body->velocity();
+                motion.angularVelocity = body->angularVelocity();
+                resolved[body] = motion;
+                body->stepPosition(remaining);
+                m_tree.update(body);
+            }
+            ++m_profile.ccdSolveCount;
+
+            schedule(event.bullet, event.toi);
+            //a body knocked fast enough must not pass into static bodies either
+            if (other->type() == Body::BodyType::Dynamic && other->velocity().lengthSquare() >= Constant::CCDMinVelocity &&
+                std::find(m_bullets.begin(), m_bullets.end(), other) == m_bullets.end())
+            {
+                m_bullets.emplace_back(other);
+                versions.emplace_back(0);
+                subSteps.emplace_back(0);
+                struck.emplace_back(true);
+                schedule(static_cast<Index>(m_bullets.size() - 1), event.toi);
+            }
+            //a body that can move took a new path, bullets that may still reach it look again
+            for (Body* body : bodies)
+            {
+                if (!IslandBuilder::linkable(body) || body->type() == Body::BodyType::Bullet)
+                    continue;
+                const AABB reach = sweepAt(body, event.toi).aabb(remaining);
+                for (Index i = 0; i < m_bullets.size(); ++i)
+                {
+                    if (m_bullets[i] != body && sweepAt(m_bullets[i], event.toi).aabb(remaining).collide(reach))
+                        schedule(i, event.toi);
                 }
             }
         }
-        //there isn't a ccd case, solve nothing.
-        return false;
+        m_profile.ccd += lap(timer);
     }
     void PhysicsSystem::solveOnce(const real& dt)
     {
@@ -128,7 +534,7 @@ namespace Physics2D
         auto potentialList = m_tree.generate();
         for (auto pair : potentialList)
         {
-            auto result = Detector::detect(pair.first, pair.second);
+            auto result = Detector::detect(pair.first, pair.second, nullptr, m_analyticContacts, m_typedKernels);
             if (result.isColliding) {
                 m_maintainer.add(result);
             }
@@ -183,45 +589,586 @@ namespace Physics2D
         	pdt = dt / real(m_positionIteration);
         }
 
-        m_world.stepVelocity(dt);
+        //the soft step and xpbd integrate the first sub-step here, the others after the detection
+        const int subSteps = m_xpbd ? std::max(m_xpbdSolver.m_subStepCount, 1) :
+                             m_softStep ? std::max(m_subStepCount, 1) : 1;
+        const real h = dt / real(subSteps);
+
+        auto timer = ProfileClock::now();
+
+        m_world.stepVelocity(h);
+        //poses may have been edited since the last step, detection below reads the cached matrices from every thread
+        m_world.bodyStore().updateRotations();
+        m_world.bodyStore().updateTransformStamps();
+        m_profile.integrateVelocity += lap(timer);
         //auto potentialList = m_grid.generate();
 
-        auto potentialList = m_tree.generate();
-        for (auto pair : potentialList)
+        //xpbd measures the penetration of its contacts on every sub-step, pairs that touch within the step need
+        //their contacts before they do
+        const auto& potentialList = m_tree.updatePairs(m_speculativeContacts || m_xpbd ? dt : 0);
+        m_profile.broadphase += lap(timer);
+        m_profile.pairCount += potentialList.size();
+
+        const bool parallel = m_parallelSolve && m_threadPool.threadCount() > 1;
+        m_maintainer.m_speculativeDeltaTime = m_speculativeContacts ? dt : 0;
+        detectPairs(potentialList, m_tree.pairCaches(), dt, parallel);
+        m_profile.narrowphase += lap(timer);
+
+        m_maintainer.clearInactivePoints();
+        m_profile.contactPointCount += m_maintainer.contactPointCount();
+
+        m_islandBuilder.build(m_world, m_maintainer);
+        auto& islands = m_islandBuilder.islands();
+        m_profile.islandCount += islands.size();
+        m_profile.awakeIslandCount += m_islandBuilder.awakeCount();
+        m_profile.buildIslands += lap(timer);
+
+        //large islands are colored and solved one by one with every thread working on the same island,
+        //the remaining ones are spread over the threads in batches.
+        //the wide solver packs manifolds of a color into lanes, so it colors large islands even on one thread
+        m_colorPool = parallel ? &m_threadPool : nullptr;
+        for (auto& island : islands)
         {
-            auto result = Detector::detect(pair.first, pair.second);
-            if (result.isColliding) {
-                m_maintainer.add(result);
+            island.colored = (parallel || m_maintainer.m_wideVelocitySolver) && !island.sleep &&
+                island.contacts.size() + island.joints.size() >= m_coloringThreshold;
+            if (island.colored)
+            {
+                m_islandBuilder.color(island, m_world.bodyStore());
+                m_profile.colorCount += island.colors.contacts.size() + island.colors.joints.size();
             }
         }
-        m_maintainer.clearInactivePoints();
+        if (parallel)
+            scheduleIslands();
+        m_profile.buildIslands += lap(timer);
 
-    	m_world.prepareVelocityConstraint(vdt);
+        //sleeping islands are skipped entirely, their bodies are neither solved nor integrated
+        auto forEachAwakeIsland = [&](const auto& function)
+        {
+            if (parallel)
+            {
+                m_threadPool.run(m_islandBatches.size(), [&](size_t batch)
+                {
+                    for (Island* island : m_islandBatches[batch])
+                        function(*island);
+                });
+                for (auto& island : islands)
+                    if (island.colored)
+                        function(island);
+                return;
+            }
+            for (auto& island : islands)
+                if (!island.sleep)
+                    function(island);
+        };
 
-        for (int i = 0; i < m_velocityIteration; ++i)
+        //xpbd projects positions and keeps no impulses to warm start with
+        if (!m_xpbd)
+            forEachAwakeIsland([&](Island& island) { prepareIsland(island, m_softStep ? h : vdt); });
+        m_profile.prepareVelocity += lap(timer);
+
+        if (m_xpbd)
         {
-            if(m_solveJointVelocity)
-				m_world.solveVelocityConstraint(vdt);
+            const Vector2 gravity = m_world.gravity() ? std::as_const(m_world).gravity() : Vector2();
+            m_world.saveLastPosition();
+            for (int i = 0; i < subSteps; ++i)
+            {
+                if (i > 0)
+                {
+                    m_world.integrateVelocity(h);
+                    m_profile.integrateVelocity += lap(timer);
+                }
+                m_xpbdSolver.beginSubStep(m_maintainer, m_world.bodyStore(), gravity, h);
 
-            if (m_solveContactVelocity)
-				m_maintainer.solveVelocity(vdt);
+                m_world.integratePosition(h);
+                m_world.bodyStore().updateRotations();
+                m_profile.integratePosition += lap(timer);
+
+                forEachAwakeIsland([&](Island& island) { solveIslandXPBD(island, h, true); });
+                m_profile.solvePosition += lap(timer);
+
+                m_xpbdSolver.updateVelocities(m_world.bodyStore(), h);
+                forEachAwakeIsland([&](Island& island) { solveIslandXPBD(island, h, false); });
+                m_profile.solveVelocity += lap(timer);
+            }
+            //forces are cleared and sleep is counted down once, after the last sub-step
+            m_world.finishStep();
+            m_maintainer.deactivateAllPoints();
+            return;
         }
 
-        m_maintainer.solveRestitution(dt);
+        if (m_softStep)
+        {
+            //the manifolds were warm started when they were prepared, right after the first sub-step was integrated
+            m_maintainer.prepareSoftStep(h);
+            m_world.saveLastPosition();
+            for (int i = 0; i < subSteps; ++i)
+            {
+                if (i > 0)
+                {
+                    m_world.integrateVelocity(h);
+                    m_profile.integrateVelocity += lap(timer);
+                    forEachAwakeIsland([&](Island& island) { warmStartIsland(island, h); });
+                    m_profile.prepareVelocity += lap(timer);
+                }
+                forEachAwakeIsland([&](Island& island) { solveIslandSoft(island, h, true); });
+                m_profile.solveVelocity += lap(timer);
+
+                m_world.integratePosition(h);
+                m_world.bodyStore().updateRotations();
+                m_profile.integratePosition += lap(timer);
+
+                forEachAwakeIsland([&](Island& island) { solveIslandSoft(island, h, false); });
+                m_profile.solvePosition += lap(timer);
+            }
+            m_world.finishStep();
+            forEachAwakeIsland([&](Island& island) { solveIslandRestitution(island, dt); });
+            m_maintainer.deactivateAllPoints();
+            m_profile.solveVelocity += lap(timer);
+            return;
+        }
+
+        forEachAwakeIsland([&](Island& island) { solveIslandVelocity(island, vdt, dt); });
+        m_profile.solveVelocity += lap(timer);
 
         m_world.stepPosition(dt);
+        //kinematic bodies are shared between islands, their matrices must not be rebuilt by the position solver
+        m_world.bodyStore().updateRotations();
+        m_profile.integratePosition += lap(timer);
 
         //solve penetration use contact pairs from previous velocity solver settings
         //TODO: Can generate another contact table just for position solving
+        forEachAwakeIsland([&](Island& island) { solveIslandPosition(island, pdt); });
+
+        m_maintainer.deactivateAllPoints();
+        m_profile.solvePosition += lap(timer);
+    }
+
+    void PhysicsSystem::detectPairs(const Container::Vector<std::pair<Body*, Body*>>& pairs,
+                                    const Container::Vector<CollisionCache*>& caches, const real& dt, bool parallel)
+    {
+        //detection only reads the bodies and writes the cache of its own pair, so chunks of pairs are detected on every thread into their own buffer
+        //and only the merge below touches the contact table
+        const size_t chunks = parallel ?
+            std::min((pairs.size() + PairGrainSize - 1) / PairGrainSize, m_threadPool.threadCount() * 4) : 1;
+        const size_t size = chunks == 0 ? 0 : (pairs.size() + chunks - 1) / chunks;
+        m_collisionBuffers.resize(std::max(m_collisionBuffers.size(), chunks));
+        m_speculativeBuffers.resize(std::max(m_speculativeBuffers.size(), chunks));
+        const bool speculative = m_speculativeContacts || m_xpbd;
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            m_collisionBuffers[i].clear();
+            m_speculativeBuffers[i].clear();
+        }
+
+        m_threadPool.run(chunks, [&](size_t chunk)
+        {
+            auto& buffer = m_collisionBuffers[chunk];
+            //a pair found apart still gets contacts when it can close the gap within the step
+            auto speculate = [&](Body* bodyA, Body* bodyB)
+            {
+                if (!speculative)
+                    return;
+                //pairs that close less than the allowed penetration are left to the contacts of the next step
+                //a contact that xpbd meets without warning is pushed out within one sub-step and turns into velocity
+                const real margin = m_xpbd ? travelDistance(bodyA, bodyB, dt) : closingDistance(bodyA, bodyB, dt);
+                if (margin < m_maintainer.m_maxPenetration)
+                    return;
+                auto result = Detector::speculate(bodyA, bodyB, margin);
+                if (result.isColliding)
+                    m_speculativeBuffers[chunk].emplace_back(std::move(result));
+            };
+            const size_t begin = chunk * size;
+            const size_t end = std::min(begin + size, pairs.size());
+            if (m_batchedRejection)
+                rejectSeparated(pairs, caches, begin, end);
+            else
+            {
+                for (size_t i = begin; i < end; ++i)
+                    caches[i]->rejected = false;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            {
+                const auto& [bodyA, bodyB] = pairs[i];
+                if (isFrozen(bodyA) && isFrozen(bodyB))
+                    continue;
+                CollisionCache& cache = *caches[i];
+                //neither body moved since the last detection, the contacts are the same and only prepared again
+                cache.reused = unchanged(cache, bodyA, bodyB);
+                if (cache.reused)
+                {
+                    if (!cache.colliding)
+                    {
+                        speculate(bodyA, bodyB);
+                        continue;
+                    }
+                    Collision& result = buffer.emplace_back();
+                    result.isColliding = true;
+                    result.bodyA = bodyA;
+                    result.bodyB = bodyB;
+                    result.contactList = cache.contacts;
+                    result.normal = cache.normal;
+                    result.penetration = cache.penetration;
+                    continue;
+                }
+                //recorded like a detection that found the pair apart
+                if (cache.rejected)
+                {
+                    cache.gjk = false;
+                    cache.detected = true;
+                    cache.transformStamp[0] = bodyA->transformStamp();
+                    cache.transformStamp[1] = bodyB->transformStamp();
+                    cache.colliding = false;
+                    speculate(bodyA, bodyB);
+                    continue;
+                }
+                auto result = Detector::detect(bodyA, bodyB, &cache, m_analyticContacts, m_typedKernels);
+                cache.detected = true;
+                cache.transformStamp[0] = bodyA->transformStamp();
+                cache.transformStamp[1] = bodyB->transformStamp();
+                cache.colliding = result.isColliding;
+                if (!result.isColliding)
+                {
+                    speculate(bodyA, bodyB);
+                    continue;
+                }
+                cache.contacts = result.contactList;
+                cache.normal = result.normal;
+                cache.penetration = result.penetration;
+                buffer.emplace_back(std::move(result));
+            }
+        });
+
+        //neither body can move, keep the manifold of the last step instead of detecting again
+        for (size_t i = 0; i < pairs.size(); ++i)
+        {
+            const auto& [bodyA, bodyB] = pairs[i];
+            if (isFrozen(bodyA) && isFrozen(bodyB))
+            {
+                m_maintainer.keepAlive(Body::BodyPair::generateBodyPairID(bodyA, bodyB));
+                continue;
+            }
+            if (caches[i]->reused)
+            {
+                ++m_profile.reusedCount;
+                continue;
+            }
+            if (caches[i]->rejected)
+            {
+                ++m_profile.rejectedCount;
+                continue;
+            }
+            if (caches[i]->gjk)
+            {
+                ++m_profile.gjkCount;
+                m_profile.gjkIterationCount += caches[i]->iterations;
+            }
+        }
+
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            for (auto& result : m_collisionBuffers[i])
+                m_maintainer.add(result);
+            m_profile.collidingCount += m_collisionBuffers[i].size();
+        }
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            for (auto& result : m_speculativeBuffers[i])
+                m_maintainer.add(result);
+            m_profile.speculativeCount += m_speculativeBuffers[i].size();
+        }
+    }
+
+    void PhysicsSystem::prepareIsland(Island& island, const real& vdt)
+    {
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            forEachColor(m_colorPool, colors.joints, colors.jointOverflow,
+                         [&](Joint* joint) { joint->prepare(vdt); });
+
+            colors.wideContacts.resize(m_maintainer.m_wideVelocitySolver ? colors.contacts.size() : 0);
+            for (size_t i = 0; i < colors.wideContacts.size(); ++i)
+            {
+                auto& color = colors.contacts[i];
+                auto& wideColor = colors.wideContacts[i];
+                constexpr size_t Lanes = WideContactConstraint::LaneCount;
+                wideColor.resize((color.size() + Lanes - 1) / Lanes);
+                for (size_t j = 0; j < wideColor.size(); ++j)
+                    m_maintainer.prepare(wideColor[j], color.data() + j * Lanes, std::min(Lanes, color.size() - j * Lanes));
+            }
+            return;
+        }
+
+        for (auto* joint : island.joints)
+            joint->prepare(vdt);
+    }
+
+    void PhysicsSystem::solveIslandVelocity(Island& island, const real& vdt, const real& dt)
+    {
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            for (int i = 0; i < m_velocityIteration; ++i)
+            {
+                if (m_solveJointVelocity)
+                    forEachColor(m_colorPool, colors.joints, colors.jointOverflow,
+                                 [&](Joint* joint) { joint->solveVelocity(vdt); });
+
+                if (!m_solveContactVelocity)
+                    continue;
+                if (colors.wideContacts.empty())
+                {
+                    forEachColor(m_colorPool, colors.contacts, colors.contactOverflow,
+                                 [&](auto* contactList) { m_maintainer.solveVelocity(*contactList, vdt); });
+                    continue;
+                }
+                forEachColor(m_colorPool, colors.wideContacts,
+                             [&](WideContactConstraint& wide) { m_maintainer.solveVelocity(wide, m_world.bodyStore()); });
+                for (auto* contactList : colors.contactOverflow)
+                    m_maintainer.solveVelocity(*contactList, vdt);
+            }
+
+            forEachColor(m_colorPool, colors.wideContacts,
+                         [&](WideContactConstraint& wide) { m_maintainer.storeImpulses(wide); });
+
+            solveIslandRestitution(island, dt);
+            return;
+        }
+
+        for (int i = 0; i < m_velocityIteration; ++i)
+        {
+            if (m_solveJointVelocity)
+                for (auto* joint : island.joints)
+                    joint->solveVelocity(vdt);
+
+            if (m_solveContactVelocity)
+                for (auto* contactList : island.contacts)
+                    m_maintainer.solveVelocity(*contactList, vdt);
+        }
+
+        solveIslandRestitution(island, dt);
+    }
+
+    void PhysicsSystem::solveIslandRestitution(Island& island, const real& dt)
+    {
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            forEachColor(m_colorPool, colors.contacts, colors.contactOverflow,
+                         [&](auto* contactList) { m_maintainer.solveRestitution(*contactList, dt); });
+            return;
+        }
+
+        for (auto* contactList : island.contacts)
+            m_maintainer.solveRestitution(*contactList, dt);
+    }
+
+    void PhysicsSystem::warmStartIsland(Island& island, const real& h)
+    {
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            forEachColor(m_colorPool, colors.joints, colors.jointOverflow,
+                         [&](Joint* joint) { joint->prepare(h); });
+            forEachColor(m_colorPool, colors.contacts, colors.contactOverflow,
+                         [&](auto* contactList) { m_maintainer.warmStart(*contactList); });
+            return;
+        }
+
+        for (auto* joint : island.joints)
+            joint->prepare(h);
+        for (auto* contactList : island.contacts)
+            m_maintainer.warmStart(*contactList);
+    }
+
+    void PhysicsSystem::solveIslandSoft(Island& island, const real& h, bool useBias)
+    {
+        const bool solveJoints = useBias ? m_solveJointVelocity : m_solveJointPosition;
+        const bool solveContacts = useBias ? m_solveContactVelocity : m_solveContactPosition;
+        auto solveJoint = [&](Joint* joint)
+        {
+            if (useBias)
+                joint->solveVelocity(h);
+            else
+                joint->solvePosition(h);
+        };
+
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            if (solveJoints)
+                forEachColor(m_colorPool, colors.joints, colors.jointOverflow, solveJoint);
+            if (solveContacts)
+                forEachColor(m_colorPool, colors.contacts, colors.contactOverflow,
+                             [&](auto* contactList) { m_maintainer.solveSoft(*contactList, h, useBias); });
+            return;
+        }
+
+        if (solveJoints)
+            for (auto* joint : island.joints)
+                solveJoint(joint);
+        if (solveContacts)
+            for (auto* contactList : island.contacts)
+                m_maintainer.solveSoft(*contactList, h, useBias);
+    }
+
+    void PhysicsSystem::solveIslandXPBD(Island& island, const real& h, bool position)
+    {
+        const bool solveJoints = position ? m_solveJointPosition : m_solveJointVelocity;
+        const bool solveContacts = position ? m_solveContactPosition : m_solveContactVelocity;
+        auto solveJoint = [&](Joint* joint)
+        {
+            if (position)
+                m_xpbdSolver.solvePosition(joint, h);
+            else
+                m_xpbdSolver.solveVelocity(joint, h);
+        };
+        auto solveContact = [&](ContactManifold* contactList)
+        {
+            if (position)
+                m_xpbdSolver.solvePosition(*contactList, h);
+            else
+                m_xpbdSolver.solveVelocity(*contactList, h);
+        };
+
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            if (solveJoints)
+                forEachColor(m_colorPool, colors.joints, colors.jointOverflow, solveJoint);
+            if (solveContacts)
+                forEachColor(m_colorPool, colors.contacts, colors.contactOverflow, solveContact);
+            return;
+        }
+
+        if (solveJoints)
+            for (auto* joint : island.joints)
+                solveJoint(joint);
+        if (solveContacts)
+            for (auto* contactList : island.contacts)
+                solveContact(contactList);
+    }
+
+    void PhysicsSystem::solveIslandPosition(Island& island, const real& pdt)
+    {
+        if (island.colored)
+        {
+            ConstraintColors& colors = island.colors;
+            for (int i = 0; i < m_positionIteration; ++i)
+            {
+                if (m_solveContactPosition)
+                    forEachColor(m_colorPool, colors.contacts, colors.contactOverflow,
+                                 [&](auto* contactList) { m_maintainer.solvePosition(*contactList, pdt); });
+
+                if (m_solveJointPosition)
+                    forEachColor(m_colorPool, colors.joints, colors.jointOverflow,
+                                 [&](Joint* joint) { joint->solvePosition(pdt); });
+            }
+            return;
+        }
+
         for (int i = 0; i < m_positionIteration; ++i)
         {
-            if(m_solveContactPosition)
-				m_maintainer.solvePosition(pdt);
+            if (m_solveContactPosition)
+                for (auto* contactList : island.contacts)
+                    m_maintainer.solvePosition(*contactList, pdt);
 
-            if(m_solveJointPosition)
-				m_world.solvePositionConstraint(pdt);
+            if (m_solveJointPosition)
+                for (auto* joint : island.joints)
+                    joint->solvePosition(pdt);
         }
+    }
 
-        m_maintainer.deactivateAllPoints();
+    void PhysicsSystem::scheduleIslands()
+    {
+        //contacts never write bodies without inverse mass and inertia, but joints and static bodies
+        //with a finite mass write them from every island that touches them,
+        //so islands sharing such a body are kept in the same batch
+        Container::Vector<Island*> awake;
+        for (auto& island : m_islandBuilder.islands())
+            if (!island.sleep && !island.colored)
+                awake.emplace_back(&island);
+
+        Container::Vector<Index> group(awake.size());
+        for (Index i = 0; i < group.size(); ++i)
+            group[i] = i;
+        auto find = [&group](Index index)
+        {
+            while (group[index] != index)
+                index = group[index] = group[group[index]];
+            return index;
+        };
+
+        Container::Map<Body*, Index> shared;
+        auto share = [&](Body* body, Index island)
+        {
+            if (body == nullptr || IslandBuilder::linkable(body))
+                return;
+            auto [iter, inserted] = shared.try_emplace(body, island);
+            if (!inserted)
+            {
+                const Index a = find(iter->second);
+                const Index b = find(island);
+                group[std::max(a, b)] = std::min(a, b);
+            }
+        };
+        auto writable = [](Body* body)
+        {
+            return body->inverseMass() != 0.0f || body->inverseInertia() != 0.0f;
+        };
+
+        //joints write their bodies unconditionally, so a body anchoring a joint is shared with every island touching it
+        for (Index i = 0; i < awake.size(); ++i)
+        {
+            for (auto* joint : awake[i]->joints)
+            {
+                share(joint->bodyA(), i);
+                share(joint->bodyB(), i);
+            }
+        }
+        for (Index i = 0; i < awake.size(); ++i)
+        {
+            for (auto* contactList : awake[i]->contacts)
+            {
+                Body* bodyA = contactList->front().bodyA;
+                Body* bodyB = contactList->front().bodyB;
+                if (writable(bodyA) || shared.contains(bodyA))
+                    share(bodyA, i);
+                if (writable(bodyB) || shared.contains(bodyB))
+                    share(bodyB, i);
+            }
+        }
+
+        //longest processing time first: hand the most expensive group to the least loaded batch
+        Container::Vector<size_t> cost(awake.size(), 0);
+        for (Index i = 0; i < awake.size(); ++i)
+            cost[find(i)] += awake[i]->contacts.size() + awake[i]->joints.size() + 1;
+
+        Container::Vector<Index> order;
+        for (Index i = 0; i < awake.size(); ++i)
+            if (find(i) == i)
+                order.emplace_back(i);
+        std::stable_sort(order.begin(), order.end(), [&cost](Index a, Index b)
+        {
+            return cost[a] > cost[b];
+        });
+
+        const size_t batchCount = std::min(m_threadPool.threadCount(), order.size());
+        m_islandBatches.resize(batchCount);
+        for (auto& batch : m_islandBatches)
+            batch.clear();
+
+        Container::Vector<size_t> load(batchCount, 0);
+        Container::Vector<Index> batchOf(awake.size(), 0);
+        for (Index root : order)
+        {
+            const size_t target = std::min_element(load.begin(), load.end()) - load.begin();
+            batchOf[root] = static_cast<Index>(target);
+            load[target] += cost[root];
+        }
+        //islands keep their build order inside a batch
+        for (Index i = 0; i < awake.size(); ++i)
+            m_islandBatches[batchOf[find(i)]].emplace_back(awake[i]);
     }
 }
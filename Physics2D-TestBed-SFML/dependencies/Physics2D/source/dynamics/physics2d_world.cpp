@@ -19,6 +19,25 @@ namespace Physics2D
 	}
 
 	void PhysicsWorld::stepVelocity(const real& dt)
+	{
+		const size_t count = m_bodyStore.size();
+		const uint8_t* sleep = m_bodyStore.sleep.data();
+		const Vector2* forces = m_bodyStore.forces.data();
+		const real* torques = m_bodyStore.torques.data();
+
+		//a sleeping body that was moved or pushed by the user wakes up, the island builder wakes the rest of its island
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!sleep[i])
+				continue;
+			if (m_bodyStore.body[i]->kineticEnergy() > Constant::MinEnergy || !forces[i].isOrigin() || torques[i] != 0.0f)
+				m_bodyStore.body[i]->setSleep(false);
+		}
+
+		integrateVelocity(dt);
+	}
+
+	void PhysicsWorld::integrateVelocity(const real& dt)
 	{
 		const Vector2 g = m_enableGravity ? m_gravity : Vector2{ 0.0, 0.0 };
 		real lvd = 1.0f;
@@ -30,53 +49,30 @@ namespace Physics2D
 			lvd = 1.0f / (1.0f + dt * m_linearVelocityDamping);
 			avd = 1.0f / (1.0f + dt * m_angularVelocityDamping);
 		}
-		for (auto& body : m_bodyList)
-		{
-			switch (body->type())
-			{
-			case Body::BodyType::Static:
-			{
-				body->velocity().clear();
-				body->angularVelocity() = 0;
-				break;
-			}
-			case Body::BodyType::Dynamic:
-			{
-				body->forces() += body->mass() * g;
 
-				if (body->sleep() && body->kineticEnergy() > Constant::MinEnergy)
-					body->setSleep(false);
-				
-				body->velocity() += body->inverseMass() * body->forces() * dt;
-				body->angularVelocity() += body->inverseInertia() * body->torques() * dt;
+		const size_t count = m_bodyStore.size();
+		const Body::BodyType* type = m_bodyStore.type.data();
+		const uint8_t* sleep = m_bodyStore.sleep.data();
 
-				body->velocity() *= lvd;
-				body->angularVelocity() *= avd;
+		Vector2* velocity = m_bodyStore.velocity.data();
+		real* angularVelocity = m_bodyStore.angularVelocity.data();
+		const Vector2* forces = m_bodyStore.forces.data();
+		const real* torques = m_bodyStore.torques.data();
+		const real* inverseMass = m_bodyStore.inverseMass.data();
+		const real* inverseInertia = m_bodyStore.inverseInertia.data();
 
-				break;
-			}
-			case Body::BodyType::Kinematic:
-			{
-				body->velocity() += body->inverseMass() * body->forces() * dt;
-				body->angularVelocity() += body->inverseInertia() * body->torques() * dt;
-
-				body->velocity() *= lvd;
-				body->angularVelocity() *= avd;
-				break;
-			}
-			case Body::BodyType::Bullet:
-			{
-				body->forces() += body->mass() * g;
-
-				body->velocity() += body->inverseMass() * body->forces() * dt;
-				body->angularVelocity() += body->inverseInertia() * body->torques() * dt;
-
-
-				body->velocity() *= lvd;
-				body->angularVelocity() *= avd;
-				break;
-			}
-			}
+		//static and sleeping bodies are zeroed, kinematic bodies ignore gravity
+		for (size_t i = 0; i < count; ++i)
+		{
+			const bool isFrozen = type[i] == Body::BodyType::Static || sleep[i];
+			const bool hasGravity = (type[i] == Body::BodyType::Dynamic || type[i] == Body::BodyType::Bullet) && inverseMass[i] > 0.0f;
+			const real gravityScale = hasGravity ? 1.0f : 0.0f;
+			const real linearScale = isFrozen ? 0.0f : lvd;
+			const real angularScale = isFrozen ? 0.0f : avd;
+
+			velocity[i].x = (velocity[i].x + (inverseMass[i] * forces[i].x + gravityScale * g.x) * dt) * linearScale;
+			velocity[i].y = (velocity[i].y + (inverseMass[i] * forces[i].y + gravityScale * g.y) * dt) * linearScale;
+			angularVelocity[i] = (angularVelocity[i] + inverseInertia[i] * torques[i] * dt) * angularScale;
 		}
 	}
 	void PhysicsWorld::solveVelocityConstraint(real dt)
@@ -94,69 +90,92 @@ namespace Physics2D
 
 	void PhysicsWorld::stepPosition(const real& dt)
 	{
+		saveLastPosition();
+		integratePosition(dt);
+		finishStep();
+	}
 
-		for (auto& body : m_bodyList)
-		{
-			switch (body->type())
-			{
-			case Body::BodyType::Static:
-				break;
-			case Body::BodyType::Dynamic:
-			{
-				body->forces().clear();
-				body->clearTorque();
-
-				body->lastPosition() = body->position();
-				body->lastRotation() = body->rotation();
+	void PhysicsWorld::saveLastPosition()
+	{
+		const size_t count = m_bodyStore.size();
+		const Vector2* position = m_bodyStore.position.data();
+		const real* rotation = m_bodyStore.rotation.data();
+		Vector2* lastPosition = m_bodyStore.lastPosition.data();
+		real* lastRotation = m_bodyStore.lastRotation.data();
 
-				body->position() += body->velocity() * dt;
-				body->rotation() += body->angularVelocity() * dt;
+		for (size_t i = 0; i < count; ++i)
+		{
+			lastPosition[i] = position[i];
+			lastRotation[i] = rotation[i];
+		}
+	}
 
-				if (body->sleep())
-					break;
+	void PhysicsWorld::finishStep()
+	{
+		const size_t count = m_bodyStore.size();
+		const Body::BodyType* type = m_bodyStore.type.data();
+		Vector2* forces = m_bodyStore.forces.data();
+		real* torques = m_bodyStore.torques.data();
+		const Vector2* velocity = m_bodyStore.velocity.data();
+		const real* angularVelocity = m_bodyStore.angularVelocity.data();
 
-				if (m_enableSleep)
-				{
-					if (body->kineticEnergy() < Constant::MinEnergy)
-						body->sleepCountdown()++;
-					else
-						body->sleepCountdown() = 0;
-
-					if (body->sleepCountdown() >= Constant::SleepCountdown) {
-						body->sleepCountdown() = 0;
-						body->setSleep(true);
-						body->velocity().clear();
-						body->angularVelocity() = 0.0f;
-					}
-				}
+		for (size_t i = 0; i < count; ++i)
+		{
+			forces[i].x = 0.0f;
+			forces[i].y = 0.0f;
+			torques[i] = 0.0f;
+		}
 
-				break;
-			}
-			case Body::BodyType::Kinematic:
+		for (size_t i = 0; i < count; ++i)
+		{
+			Body* body = m_bodyStore.body[i];
+			switch (type[i])
 			{
-				body->position() += body->velocity() * dt;
-				body->rotation() += body->angularVelocity() * dt;
+			case Body::BodyType::Dynamic:
+			{
+				//only count down here, the island builder puts whole islands to sleep
+				if (!m_enableSleep || body->sleep())
+					break;
 
-				body->forces().clear();
-				body->clearTorque();
+				//a resting body in a pile keeps a small residual velocity from gravity and the solver,
+				//so use the world thresholds rather than an energy that never reaches zero
+				if (velocity[i].lengthSquare() < m_linearVelocityThreshold * m_linearVelocityThreshold &&
+					Math::abs(angularVelocity[i]) < m_angularVelocityThreshold)
+					body->sleepCountdown()++;
+				else
+					body->sleepCountdown() = 0;
 				break;
 			}
 			case Body::BodyType::Bullet:
 			{
-				body->position() += body->velocity() * dt;
-				body->rotation() += body->angularVelocity() * dt;
-
-				body->forces().clear();
-				body->clearTorque();
-
 				if (body->velocity().lengthSquare() < Constant::CCDMinVelocity * Constant::CCDMinVelocity
 					&& body->rotation() < Constant::CCDMinVelocity)
 					body->setType(Body::BodyType::Dynamic);
 				break;
 			}
+			default:
+				break;
 			}
 		}
+	}
 
+	void PhysicsWorld::integratePosition(const real& dt)
+	{
+		const size_t count = m_bodyStore.size();
+		const Body::BodyType* type = m_bodyStore.type.data();
+		Vector2* position = m_bodyStore.position.data();
+		real* rotation = m_bodyStore.rotation.data();
+		const Vector2* velocity = m_bodyStore.velocity.data();
+		const real* angularVelocity = m_bodyStore.angularVelocity.data();
+		const uint8_t* sleep = m_bodyStore.sleep.data();
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const real step = type[i] == Body::BodyType::Static || sleep[i] ? 0.0f : dt;
+			position[i].x += velocity[i].x * step;
+			position[i].y += velocity[i].y * step;
+			rotation[i] += angularVelocity[i] * step;
+		}
 	}
 
 	real PhysicsWorld::bias() const
@@ -171,16 +190,21 @@ namespace Physics2D
 
 
 
-	Container::Vector<std::unique_ptr<Body>>& PhysicsWorld::bodyList()
+	Container::Vector<PoolPtr<Body>>& PhysicsWorld::bodyList()
 	{
 		return m_bodyList;
 	}
 
-	Container::Vector<std::unique_ptr<Joint>>& PhysicsWorld::jointList()
+	Container::Vector<PoolPtr<Joint>>& PhysicsWorld::jointList()
 	{
 		return m_jointList;
 	}
 
+	BodyStore& PhysicsWorld::bodyStore()
+	{
+		return m_bodyStore;
+	}
+
 	bool& PhysicsWorld::enableSleep()
 	{
 		return m_enableSleep;
@@ -269,10 +293,9 @@ namespace Physics2D
 
 	Body* PhysicsWorld::createBody()
 	{
-		auto body = std::make_unique<Body>();
-		Body* temp = body.get();
+		Body* temp = m_bodyPool.create(&m_bodyStore);
 		temp->setId(RandomGenerator::unique());
-		m_bodyList.emplace_back(std::move(body));
+		m_bodyList.emplace_back(temp, m_bodyPool.deleter());
 		return temp;
 	}
 
@@ -283,7 +306,7 @@ namespace Physics2D
 			if (iter->get() == body)
 			{
 				RandomGenerator::pop(body->id());
-				iter->release();
+				m_bodyStore.remove(body->storeIndex());
 				m_bodyList.erase(iter);
 				break;
 			}
@@ -297,7 +320,6 @@ namespace Physics2D
 			if (iter->get() == joint)
 			{
 				RandomGenerator::pop(joint->id());
-				iter->release();
 				m_jointList.erase(iter);
 				break;
 			}
@@ -306,104 +328,92 @@ namespace Physics2D
 
 	void PhysicsWorld::clearAllBodies()
 	{
-		for (auto& body : m_bodyList)
-			body.release();
+		//slots go back to the pool free lists, blocks are kept for the next scene
 		m_bodyList.clear();
+		m_bodyStore.clear();
 	}
 
 	void PhysicsWorld::clearAllJoints()
 	{
-		for (auto& joint : m_jointList)
-			joint.release();
 		m_jointList.clear();
 	}
 
 	PrismaticJoint* PhysicsWorld::createJoint(const PrismaticJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<PrismaticJoint>(primitive);
-		PrismaticJoint* temp = joint.get();
+		PrismaticJoint* temp = m_prismaticJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_prismaticJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	RotationJoint* PhysicsWorld::createJoint(const RotationJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<RotationJoint>(primitive);
-		RotationJoint* temp = joint.get();
+		RotationJoint* temp = m_rotationJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_rotationJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	PointJoint* PhysicsWorld::createJoint(const PointJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<PointJoint>(primitive);
-		PointJoint* temp = joint.get();
+		PointJoint* temp = m_pointJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_pointJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	DistanceJoint* PhysicsWorld::createJoint(const DistanceJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<DistanceJoint>(primitive);
-		DistanceJoint* temp = joint.get();
+		DistanceJoint* temp = m_distanceJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_distanceJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	PulleyJoint* PhysicsWorld::createJoint(const PulleyJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<PulleyJoint>(primitive);
-		PulleyJoint* temp = joint.get();
+		PulleyJoint* temp = m_pulleyJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_pulleyJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	RevoluteJoint* PhysicsWorld::createJoint(const RevoluteJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<RevoluteJoint>(primitive);
-		RevoluteJoint* temp = joint.get();
+		RevoluteJoint* temp = m_revoluteJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_revoluteJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	MotorJoint* PhysicsWorld::createJoint(const MotorJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<MotorJoint>(primitive);
-		MotorJoint* temp = joint.get();
+		MotorJoint* temp = m_motorJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_motorJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	WeldJoint* PhysicsWorld::createJoint(const WeldJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<WeldJoint>(primitive);
-		WeldJoint* temp = joint.get();
+		WeldJoint* temp = m_weldJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_weldJointPool.deleter<Joint>());
 		return temp;
 	}
 	OrientationJoint* PhysicsWorld::createJoint(const OrientationJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<OrientationJoint>(primitive);
-		OrientationJoint* temp = joint.get();
+		OrientationJoint* temp = m_orientationJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_orientationJointPool.deleter<Joint>());
 		return temp;
 	}
 
 	PathJoint* PhysicsWorld::createJoint(const PathJointPrimitive& primitive)
 	{
-		auto joint = std::make_unique<PathJoint>(primitive);
-		PathJoint* temp = joint.get();
+		PathJoint* temp = m_pathJointPool.create(primitive);
 		temp->setId(RandomGenerator::unique());
-		m_jointList.emplace_back(std::move(joint));
+		m_jointList.emplace_back(temp, m_pathJointPool.deleter<Joint>());
 		return temp;
 	}
 }
@@ -0,0 +1,125 @@
+#include "physics2d_thread_pool.h"
+
+namespace Physics2D
+{
+	ThreadPool::~ThreadPool()
+	{
+		stop();
+	}
+
+	void ThreadPool::setThreadCount(size_t count)
+	{
+		if (count == m_threadCount)
+			return;
+		stop();
+		m_threadCount = count;
+	}
+
+	size_t ThreadPool::threadCount() const
+	{
+		if (m_threadCount != 0)
+			return m_threadCount;
+		return std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+	}
+
+	void ThreadPool::run(size_t count, const std::function<void(size_t)>& task)
+	{
+		if (count == 0)
+			return;
+
+		if (count == 1 || threadCount() == 1)
+		{
+			for (size_t i = 0; i < count; ++i)
+				task(i);
+			return;
+		}
+
+		if (m_workers.empty())
+			start();
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_task = &task;
+			m_taskCount = count;
+			m_next.store(0, std::memory_order_relaxed);
+			m_busy = m_workers.size();
+			++m_generation;
+		}
+		m_wake.notify_all();
+
+		drain();
+
+		std::unique_lock lock(m_mutex);
+		m_finished.wait(lock, [this] { return m_busy == 0; });
+		m_task = nullptr;
+	}
+
+	void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body)
+	{
+		if (count == 0)
+			return;
+		grain = std::max(grain, static_cast<size_t>(1));
+		//a few ranges per thread so that uneven ranges still balance out
+		const size_t ranges = std::min((count + grain - 1) / grain, threadCount() * 4);
+		const size_t size = (count + ranges - 1) / ranges;
+		run(ranges, [&](size_t range)
+		{
+			const size_t begin = range * size;
+			const size_t end = std::min(begin + size, count);
+			if (begin < end)
+				body(begin, end);
+		});
+	}
+
+	void ThreadPool::start()
+	{
+		const size_t workers = threadCount() - 1;
+		m_stop = false;
+		m_workers.reserve(workers);
+		for (size_t i = 0; i < workers; ++i)
+			m_workers.emplace_back(&ThreadPool::work, this, m_generation);
+	}
+
+	void ThreadPool::stop()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+	}
+
+	void ThreadPool::work(uint64_t generation)
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock lock(m_mutex);
+				m_wake.wait(lock, [&] { return m_stop || m_generation != generation; });
+				if (m_stop)
+					return;
+				generation = m_generation;
+			}
+
+			drain();
+
+			std::lock_guard lock(m_mutex);
+			if (--m_busy == 0)
+				m_finished.notify_one();
+		}
+	}
+
+	void ThreadPool::drain()
+	{
+		for (;;)
+		{
+			const size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+			if (index >= m_taskCount)
+				return;
+			(*m_task)(index);
+		}
+	}
+}
@@ -121,7 +121,7 @@ namespace Physics2D
 					gjkInfo, RenderConstant::Orange, *m_settings.font);*/
 			if (gjkInfo.containsOrigin())
 			{
-				auto epaInfo = Narrowphase::epa(gjkInfo, shape1, shape2);
+				auto epaInfo = Narrowphase::epa(gjkInfo, shape1, shape2, 30, Constant::GeometryEpsilon, true);
 				if(push)
 				{
 					if (clickObject != nullptr)
@@ -162,7 +162,7 @@ namespace Physics2D
 			}
 			else
 			{
-				auto info = Narrowphase::gjkDistance(shape1, shape2);
+				auto info = Narrowphase::gjkDistance(shape1, shape2, 10, true);
 
 
 				if (showPolytope)
@@ -1,9 +1,11 @@
 #ifndef PHYSICS2D_SCENES_XPBD_H
 #define PHYSICS2D_SCENES_XPBD_H
 #include "frame.h"
+#include "worlds/xpbd.h"
 
 namespace Physics2D
 {
+	//toggle XPBD to compare the solver backends on the same world
 	class XPBDFrame : public Frame
 	{
 	public:
@@ -13,19 +15,25 @@ namespace Physics2D
 
 		void onLoad() override
 		{
+			world.create(m_settings.world, m_settings.tree);
 		}
 
 		void onPostRender(sf::RenderWindow& window) override
 		{
 		}
 
+		void onRenderUI() override
+		{
+			ImGui::Begin("XPBD");
+			ImGui::Checkbox("XPBD", &m_settings.system->xpbd());
+			ImGui::SliderInt("Sub Steps", &m_settings.system->xpbdSolver().m_subStepCount, 1, 40);
+			ImGui::DragFloat("Contact Compliance", &m_settings.system->xpbdSolver().m_contactCompliance, 1e-6f, 0.0f, 1e-3f, "%.6f");
+			ImGui::DragFloat("Joint Compliance", &m_settings.system->xpbdSolver().m_jointCompliance, 1e-6f, 0.0f, 1e-3f, "%.6f");
+			ImGui::End();
+		}
+
 	private:
-		Vector2 positions[10];
-		Vector2 velocities[10];
-		Vector2 masses[10];
-		real distance = 1;
-		real d;
-		real k;
+		XPBDWorld world;
 	};
 }
 #endif
@@ -491,9 +491,9 @@ namespace Physics2D
 		pink.a = 200;
 		yellow.a = 200;
 
-		for (auto iter = m_maintainer->m_contactTable.begin(); iter != m_maintainer->m_contactTable.end(); ++iter)
+		for (auto& contactList : m_maintainer->m_contactTable)
 		{
-			for (auto& elem : iter->second)
+			for (auto& elem : contactList)
 			{
 				const Vector2 realA = elem.bodyA->toWorldPoint(elem.vcp.localA);
 				const Vector2 realB = elem.bodyB->toWorldPoint(elem.vcp.localB);
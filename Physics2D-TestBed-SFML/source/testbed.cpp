@@ -488,6 +488,16 @@ namespace Physics2D
 		ImGui::Checkbox("Pos Block Solver", &m_system.maintainer().m_positionBlockSolver);
 		ImGui::NextColumn();
 		ImGui::Columns(1, nullptr);
+		ImGui::Checkbox("Parallel Islands", &m_system.parallelSolve());
+		ImGui::Checkbox("Wide Solver", &m_system.maintainer().m_wideVelocitySolver);
+		ImGui::Checkbox("Analytic Contacts", &m_system.analyticContacts());
+		ImGui::Checkbox("Typed Kernels", &m_system.typedKernels());
+		ImGui::Checkbox("Batched Rejection", &m_system.batchedRejection());
+		ImGui::Checkbox("Speculative Contacts", &m_system.speculativeContacts());
+		ImGui::Checkbox("Soft Step", &m_system.softStep());
+		ImGui::SliderInt("Sub Steps", &m_system.subStepCount(), 1, 16);
+		ImGui::Checkbox("XPBD", &m_system.xpbd());
+		ImGui::SliderInt("XPBD Sub Steps", &m_system.xpbdSolver().m_subStepCount, 1, 40);
 
 		ImGui::Separator();
 		ImGui::Text("Visible");
@@ -537,6 +547,39 @@ namespace Physics2D
 		ImGui::Columns(1, nullptr);
 
 
+		ImGui::Separator();
+		ImGui::Text("Profile");
+		{
+			const StepProfile& profile = m_system.profile();
+			const auto history = m_system.profileHistory();
+			float totals[Constant::ProfileHistoryCount] = {};
+			for (size_t i = 0; i < history.size(); ++i)
+				totals[i] = static_cast<float>(history[i].total);
+			ImGui::PlotLines("Step (ms)", totals, static_cast<int>(history.size()));
+
+			ImGui::Columns(2, nullptr);
+			ImGui::Text("Total: %.3f ms", profile.total);
+			ImGui::Text("Integrate Vel: %.3f ms", profile.integrateVelocity);
+			ImGui::Text("Broadphase: %.3f ms", profile.broadphase);
+			ImGui::Text("Narrowphase: %.3f ms", profile.narrowphase);
+			ImGui::Text("Islands: %.3f ms", profile.buildIslands);
+			ImGui::Text("Prepare: %.3f ms", profile.prepareVelocity);
+			ImGui::Text("Solve Vel: %.3f ms", profile.solveVelocity);
+			ImGui::NextColumn();
+			ImGui::Text("Integrate Pos: %.3f ms", profile.integratePosition);
+			ImGui::Text("Solve Pos: %.3f ms", profile.solvePosition);
+			ImGui::Text("Update Tree: %.3f ms", profile.updateTree);
+			ImGui::Text("CCD: %.3f ms", profile.ccd);
+			ImGui::Text("Pairs: %zu / %zu  Speculative: %zu  Reused: %zu  Rejected: %zu", profile.collidingCount,
+			            profile.pairCount, profile.speculativeCount, profile.reusedCount, profile.rejectedCount);
+			ImGui::Text("Points: %zu  CCD Solves: %zu  TOI Queries: %zu", profile.contactPointCount, profile.ccdSolveCount,
+			            profile.toiQueryCount);
+			ImGui::Text("Islands: %zu / %zu awake", profile.awakeIslandCount, profile.islandCount);
+			ImGui::Text("Colors: %zu", profile.colorCount);
+			ImGui::NextColumn();
+			ImGui::Columns(1, nullptr);
+		}
+
 		ImGui::Separator();
 		ImGui::Text("Running: %s", m_running ? "True" : "False");
 
@@ -0,0 +1,100 @@
+#ifndef PHYSICS2D_WORLDS_DOMINO_H
+#define PHYSICS2D_WORLDS_DOMINO_H
+#include "physics2d.h"
+
+namespace Physics2D
+{
+	//the domino world of the testbed and the benchmark, kept free of rendering so both of them create the same bodies
+	class DominoWorld
+	{
+	public:
+		void create(PhysicsWorld* world, Tree* tree)
+		{
+			floor.set(15.0f, 0.8f);
+			rectangle.set(0.5f, 0.5f);
+			brick.set(0.35f, 2.5f);
+			edge.set(Vector2{-100.0f, 0}, Vector2{100.0f, 0});
+
+			Body* ground = world->createBody();
+			ground->setShape(&edge);
+			ground->setType(Body::BodyType::Static);
+			ground->setMass(Constant::Max);
+			ground->position().set({0, 0.0f});
+			ground->setFriction(0.1f);
+			ground->setRestitution(0.0f);
+			tree->insert(ground);
+
+			Body* tile = world->createBody();
+			tile->setShape(&floor);
+			tile->setType(Body::BodyType::Static);
+			tile->setMass(Constant::Max);
+			tile->setFriction(0.1f);
+			tile->setRestitution(0.0f);
+			tile->rotation() = Math::degreeToRadian(20);
+			tile->position().set({4, 10});
+			tree->insert(tile);
+
+			tile = world->createBody();
+			tile->setShape(&floor);
+			tile->setType(Body::BodyType::Static);
+			tile->setMass(Constant::Max);
+			tile->setFriction(0.1f);
+			tile->setRestitution(0.0f);
+			tile->rotation() = Math::degreeToRadian(-20);
+			tile->position().set({-4, 4});
+			tree->insert(tile);
+
+			tile = world->createBody();
+			tile->setShape(&floor);
+			tile->setType(Body::BodyType::Static);
+			tile->setMass(Constant::Max);
+			tile->setFriction(0.2f);
+			tile->setRestitution(0.0f);
+			tile->rotation() = 0;
+			tile->position().set({-5, 13});
+			tree->insert(tile);
+
+			for (real i = 0; i < 13.0; i += 1.0f)
+			{
+				Body* card = world->createBody();
+				card->setShape(&brick);
+				card->setMass(1.5f);
+				card->setFriction(0.5f);
+				card->setRestitution(0);
+				card->setType(Body::BodyType::Dynamic);
+				card->position().set({-9.8f + i * 1.0f, 15.0f});
+				tree->insert(card);
+			}
+
+			Body* stammer = world->createBody();
+			stammer->setShape(&rectangle);
+			stammer->setMass(10.0f);
+			stammer->setFriction(0.1f);
+			stammer->setType(Body::BodyType::Dynamic);
+			stammer->position().set(-16.0f, 19.5f);
+			tree->insert(stammer);
+
+			DistanceJointPrimitive djp;
+			djp.bodyA = stammer;
+			djp.bodyB = ground;
+			djp.localPointA.set(0, 0);
+			djp.localPointB.set(-12.0f, 19.5f);
+			djp.minDistance = 4.0f;
+			djp.maxDistance = 4.0f;
+			world->createJoint(djp);
+
+			OrientationJointPrimitive ojp;
+			ojp.targetPoint.set(-12.0f, 19.5f);
+			ojp.bodyA = stammer;
+			ojp.referenceRotation = 0;
+			world->createJoint(ojp);
+		}
+
+	private:
+		Rectangle brick;
+		Rectangle floor;
+		Edge edge;
+		Rectangle rectangle;
+	};
+}
+#endif
@@ -0,0 +1,49 @@
+#ifndef PHYSICS2D_WORLDS_STACKING_H
+#define PHYSICS2D_WORLDS_STACKING_H
+#include "physics2d.h"
+
+namespace Physics2D
+{
+	//the stacking world of the testbed and the benchmark, kept free of rendering so both of them create the same bodies
+	class StackingWorld
+	{
+	public:
+		void create(PhysicsWorld* world, Tree* tree)
+		{
+			edge.set({-100, 0}, {100, 0});
+			rectangle.set(1.0f, 1.0f);
+
+			Body* ground = world->createBody();
+			ground->setShape(&edge);
+			ground->position().set({0.0, 0.0});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(1.0f);
+			tree->insert(ground);
+
+			real offset = 0.5f;
+			real max = 25.0;
+			for (real j = 0; j < max; j += 1.0f)
+			{
+				for (real i = 0.0; i < max - j; i += 1.0f)
+				{
+					Body* body = world->createBody();
+					body->position().set({-10.0f + i * 1.05f + offset, j * 1.05f + 0.6f});
+					body->setShape(&rectangle);
+					body->rotation() = 0;
+					body->setMass(1.0f);
+					body->setType(Body::BodyType::Dynamic);
+					body->setFriction(1.0f);
+					body->setRestitution(0.0f);
+					tree->insert(body);
+				}
+				offset += 0.5f;
+			}
+		}
+
+	private:
+		Rectangle rectangle;
+		Edge edge;
+	};
+}
+#endif
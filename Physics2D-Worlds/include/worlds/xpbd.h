@@ -0,0 +1,134 @@
+#ifndef PHYSICS2D_WORLDS_XPBD_H
+#define PHYSICS2D_WORLDS_XPBD_H
+#include "physics2d.h"
+
+namespace Physics2D
+{
+	//box stacks, a wrecking ball on a rope of distance joints that swings into them, a chain of revolute joints
+	//that falls onto a welded cantilever. the testbed and the benchmark run it with and without xpbd to compare
+	//the solver backends on the same world
+	class XPBDWorld
+	{
+	public:
+		void create(PhysicsWorld* world, Tree* tree)
+		{
+			m_world = world;
+			m_tree = tree;
+
+			block.set(1000.0f, 60.0f);
+			rect.set(1.0f, 1.0f);
+			link.set(1.0f, 0.25f);
+			beam.set(2.0f, 0.5f);
+			knot.setRadius(0.2f);
+			ball.setRadius(2.0f);
+
+			Body* ground = world->createBody();
+			ground->setShape(&block);
+			ground->position().set({0, -30});
+			ground->setMass(Constant::Max);
+			ground->setType(Body::BodyType::Static);
+			ground->setFriction(0.9f);
+			tree->insert(ground);
+
+			for (int i = 0; i < 10; ++i)
+			{
+				for (int j = 0; j < 20; ++j)
+				{
+					Body* body = createBody(&rect, {-30.0f + static_cast<real>(i) * 3.0f,
+					                                static_cast<real>(j) * 1.05f + 0.55f}, 1.0f);
+					body->setFriction(0.5f);
+				}
+			}
+
+			//rope hangs from (-15, 40) and starts out level, the ball reaches the top rows of the stacks
+			DistanceJointPrimitive rope;
+			rope.minDistance = 1.5f;
+			rope.maxDistance = 1.5f;
+			Body* last = ground;
+			Vector2 anchor = ground->toLocalPoint({-15.0f, 40.0f});
+			for (int i = 1; i <= 14; ++i)
+			{
+				const Vector2 position(-15.0f - static_cast<real>(i) * 1.5f, 40.0f);
+				Body* body = i < 14 ? createBody(&knot, position, 0.5f) : createBody(&ball, position, 50.0f);
+				rope.bodyA = body;
+				rope.bodyB = last;
+				rope.localPointA.clear();
+				rope.localPointB = anchor;
+				world->createJoint(rope);
+				last = body;
+				anchor.clear();
+			}
+
+			//cantilever of beams welded end to end. the weld spring is measured on the mass of both bodies, so the first
+			//beam is held at (10, 10) by a hinge and a rotation joint instead of a weld to the ground
+			RevoluteJointPrimitive root;
+			root.bodyA = createBody(&beam, {11.0f, 10.0f}, 1.0f);
+			root.bodyB = ground;
+			root.localPointA.set(-1.0f, 0.0f);
+			root.localPointB = ground->toLocalPoint({10.0f, 10.0f});
+			root.angularLimit = false;
+			root.maxForce = Constant::Max;
+			world->createJoint(root);
+			RotationJointPrimitive fixed;
+			fixed.bodyA = root.bodyA;
+			fixed.bodyB = ground;
+			world->createJoint(fixed);
+
+			WeldJointPrimitive weld;
+			weld.frequency = 5.0f;
+			last = root.bodyA;
+			for (int i = 1; i < 10; ++i)
+			{
+				Body* body = createBody(&beam, {11.0f + static_cast<real>(i) * 2.0f, 10.0f}, 1.0f);
+				weld.bodyA = body;
+				weld.bodyB = last;
+				weld.localPointA.set(-1.0f, 0.0f);
+				weld.localPointB.set(1.0f, 0.0f);
+				world->createJoint(weld);
+				last = body;
+			}
+
+			//chain hinged to the ground at (20, 40), it starts out level and drapes over the cantilever
+			RevoluteJointPrimitive hinge;
+			hinge.angularLimit = false;
+			hinge.maxForce = Constant::Max;
+			last = ground;
+			anchor = ground->toLocalPoint({20.0f, 40.0f});
+			for (int i = 0; i < 30; ++i)
+			{
+				Body* body = createBody(&link, {20.5f + static_cast<real>(i), 40.0f}, 0.5f);
+				hinge.bodyA = body;
+				hinge.bodyB = last;
+				hinge.localPointA.set(-0.5f, 0.0f);
+				hinge.localPointB = anchor;
+				world->createJoint(hinge);
+				last = body;
+				anchor.set(0.5f, 0.0f);
+			}
+		}
+
+	private:
+		Body* createBody(Shape* shape, const Vector2& position, real mass)
+		{
+			Body* body = m_world->createBody();
+			body->setShape(shape);
+			body->position() = position;
+			body->setMass(mass);
+			body->setType(Body::BodyType::Dynamic);
+			body->setFriction(0.3f);
+			body->setRestitution(0.0f);
+			m_tree->insert(body);
+			return body;
+		}
+
+		Rectangle block;
+		Rectangle rect;
+		Rectangle link;
+		Rectangle beam;
+		Circle knot;
+		Circle ball;
+		PhysicsWorld* m_world = nullptr;
+		Tree* m_tree = nullptr;
+	};
+}
+#endif
@@ -22,6 +22,9 @@ target("Physics2D")
     add_files("Physics2D-TestBed-SFML/dependencies/Physics2D/source/dynamics/*.cpp")
     add_files("Physics2D-TestBed-SFML/dependencies/Physics2D/source/math/*.cpp")
     add_files("Physics2D-TestBed-SFML/dependencies/Physics2D/source/other/*.cpp")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
 
 
 target("Physics2D-TestBed-SFML")
@@ -49,4 +52,14 @@ target("Physics2D-TestBed-SFML")
         else
             print("font folder not found in project directory.")
         end
-    end)
\ No newline at end of file
+    end)
+
+
+target("Physics2D-Benchmark")
+    set_kind("binary")
+    add_headerfiles("Physics2D-Benchmark/include/**.h")
+    add_includedirs("Physics2D-Benchmark/include")
+    add_includedirs("Physics2D-TestBed-SFML/dependencies/Physics2D/include")
+    add_files("Physics2D-Benchmark/source/*.cpp")
+    add_files("Physics2D-Benchmark/main.cpp")
+    add_deps("Physics2D")